@@ -22,11 +22,19 @@ public class BT_Dialogue : ModuleRules
             {
                 "CoreUObject",
                 "Engine",
+                "AssetRegistry",
+                "BlueprintTasksExtension",
                 "Slate",
-                "SlateCore"
+                "SlateCore",
+                "UMG"
             }
         );
         
+        if (Target.bBuildEditor)
+        {
+            PrivateDependencyModuleNames.Add("UnrealEd");
+        }
+        
         //Check if the Hermes plugin exists
         if(Plugins.GetPlugin("TagFacts") != null)
         {
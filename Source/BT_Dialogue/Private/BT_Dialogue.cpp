@@ -1,15 +1,45 @@
 ﻿#include "BT_Dialogue.h"
 
+#include "DialogueTask.h"
+#include "Internationalization/Internationalization.h"
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
 #define LOCTEXT_NAMESPACE "FBT_DialogueModule"
 
+DEFINE_LOG_CATEGORY(LogDialogue);
+
 void FBT_DialogueModule::StartupModule()
 {
-    
+    //Cached dialogue text is in the old culture
+    CultureChangedHandle = FInternationalization::Get().OnCultureChanged().AddStatic(&UDialogueTask::InvalidateAllTextCaches);
+
+#if WITH_EDITOR
+    //Bake before the compiler copies the node templates into the generated class
+    FCoreDelegates::OnPostEngineInit.AddLambda([this]()
+    {
+        if(GEditor)
+        {
+            BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddStatic(&UDialogueTask::BakeBlueprintPrefetchTargets);
+        }
+    });
+#endif
 }
 
 void FBT_DialogueModule::ShutdownModule()
 {
-    
+    if(FInternationalization::IsAvailable())
+    {
+        FInternationalization::Get().OnCultureChanged().Remove(CultureChangedHandle);
+    }
+
+#if WITH_EDITOR
+    if(GEditor)
+    {
+        GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+    }
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
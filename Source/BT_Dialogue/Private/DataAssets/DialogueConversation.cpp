@@ -0,0 +1,240 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "DataAssets/DialogueConversation.h"
+
+#include "BT_Dialogue.h"
+#include "DialogueObjects/DialogueCondition.h"
+#include "UObject/ObjectSaveContext.h"
+#if WITH_EDITOR
+#include "DialogueGraphUtils.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+#include "Engine/Blueprint.h"
+#endif
+
+TConstArrayView<FDialogueConversationOption> UDialogueConversation::GetNodeOptions(int32 NodeIndex) const
+{
+	const FDialogueConversationNode* Node = GetNode(NodeIndex);
+	if(!Node || Node->OptionCount <= 0 || !Options.IsValidIndex(Node->FirstOption + Node->OptionCount - 1))
+	{
+		return TConstArrayView<FDialogueConversationOption>();
+	}
+
+	return MakeArrayView(Options).Slice(Node->FirstOption, Node->OptionCount);
+}
+
+#if WITH_EDITOR
+void UDialogueConversation::Rebuild()
+{
+	UBlueprint* Blueprint = SourceBlueprint.LoadSynchronous();
+	if(!Blueprint)
+	{
+		UE_LOG(LogDialogue, Warning, TEXT("%s has no source blueprint to flatten"), *GetPathName());
+		return;
+	}
+
+	TArray<FString> Messages;
+	BuildFromBlueprint(Blueprint, Messages);
+
+	for(const FString& Message : Messages)
+	{
+		UE_LOG(LogDialogue, Warning, TEXT("%s: %s"), *GetPathName(), *Message);
+	}
+}
+
+bool UDialogueConversation::BuildFromBlueprint(UBlueprint* Blueprint, TArray<FString>& OutMessages)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UDialogueConversation::BuildFromBlueprint)
+
+	Modify();
+
+	//The conditions duplicated by the last build are replaced, don't leave them in the asset
+	for(const FDialogueConversationOption& Option : Options)
+	{
+		for(UDialogueCondition* Condition : Option.ConditionSettings.Conditions)
+		{
+			if(Condition)
+			{
+				Condition->Rename(nullptr, GetTransientPackage(), REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+				Condition->MarkAsGarbage();
+			}
+		}
+	}
+
+	Nodes.Reset();
+	Options.Reset();
+	EntryNodes.Reset();
+
+	if(!Blueprint)
+	{
+		return false;
+	}
+
+	TArray<UEdGraph*> Graphs;
+	Graphs.Append(Blueprint->UbergraphPages);
+	Graphs.Append(Blueprint->FunctionGraphs);
+
+	//Every dialogue node gets a row first, so edges can point ahead
+	TArray<TPair<const UEdGraphNode*, UDialogueTask*>> DialogueNodes;
+	TMap<const UEdGraphNode*, int32> NodeIndices;
+	for(const UEdGraph* Graph : Graphs)
+	{
+		if(!Graph)
+		{
+			continue;
+		}
+
+		for(const UEdGraphNode* GraphNode : Graph->Nodes)
+		{
+			UDialogueTask* Template = GraphNode ? DialogueGraph::FindDialogueTemplate(GraphNode) : nullptr;
+			if(!Template)
+			{
+				continue;
+			}
+
+			NodeIndices.Add(GraphNode, DialogueNodes.Num());
+			DialogueNodes.Add({GraphNode, Template});
+		}
+	}
+
+	if(DialogueNodes.IsEmpty())
+	{
+		OutMessages.Add(FString::Printf(TEXT("%s does not contain any dialogue nodes"), *Blueprint->GetName()));
+		return false;
+	}
+
+	TArray<bool> IsTarget;
+	IsTarget.Init(false, DialogueNodes.Num());
+
+	/**Resolve the first dialogue node @Pin leads to.
+	 * Returns INDEX_NONE if the pin ends the conversation or
+	 * leads into logic that can't be flattened. */
+	auto FindNextNode = [&](const UEdGraphPin* Pin, const FString& Source) -> int32
+	{
+		if(Pin->LinkedTo.IsEmpty())
+		{
+			return INDEX_NONE;
+		}
+
+		TSet<const UEdGraphNode*> Visited;
+		TArray<TPair<const UEdGraphNode*, UDialogueTask*>> NextNodes;
+		DialogueGraph::GatherNextDialogueNodes(Pin, 0, Visited, NextNodes);
+
+		if(NextNodes.IsEmpty())
+		{
+			OutMessages.Add(FString::Printf(TEXT("%s continues into blueprint logic that isn't part of the conversation, it ends there"), *Source));
+			return INDEX_NONE;
+		}
+
+		if(NextNodes.Num() > 1)
+		{
+			OutMessages.Add(FString::Printf(TEXT("%s branches into %i dialogue nodes, only %s is used"),
+				*Source, NextNodes.Num(), *NextNodes[0].Key->GetName()));
+		}
+
+		const int32* NextNode = NodeIndices.Find(NextNodes[0].Key);
+		if(!NextNode)
+		{
+			return INDEX_NONE;
+		}
+
+		IsTarget[*NextNode] = true;
+		return *NextNode;
+	};
+
+	Nodes.Reserve(DialogueNodes.Num());
+	for(const TPair<const UEdGraphNode*, UDialogueTask*>& DialogueNode : DialogueNodes)
+	{
+		const UEdGraphNode* GraphNode = DialogueNode.Key;
+		UDialogueTask* Template = DialogueNode.Value;
+		const FDialogueScript& Script = Template->Script;
+
+		for(const FString& Error : Template->ValidateNodeDuringCompilation())
+		{
+			OutMessages.Add(FString::Printf(TEXT("%s: %s"), *GraphNode->GetName(), *Error));
+		}
+
+		FDialogueConversationNode& Node = Nodes.AddDefaulted_GetRef();
+		Node.Character = Script.Character;
+		Node.CharacterDialogue = Script.CharacterDialogue;
+		Node.DialogueType = Script.DialogueType;
+		Node.NotInteractive = Script.NotInteractive;
+		Node.FinishDelay = Script.FinishDelay;
+		Node.SourceNode = GraphNode->GetFName();
+		Node.FirstOption = Options.Num();
+
+		if(!Script.NotInteractive)
+		{
+			Node.OptionCount = Script.DialogueOptions.Num();
+			for(const FDialogueTaskOption& TaskOption : Script.DialogueOptions)
+			{
+				FDialogueConversationOption& Option = Options.AddDefaulted_GetRef();
+				Option.ButtonText = TaskOption.ButtonText;
+				Option.DialogueTexts = TaskOption.DialogueTexts;
+				Option.MemorySettings = TaskOption.MemorySettings;
+				Option.ConditionSettings.HideIfConditionsAreNotMet = TaskOption.ConditionSettings.HideIfConditionsAreNotMet;
+				Option.ConditionSettings.ConditionHandling = TaskOption.ConditionSettings.ConditionHandling;
+
+				//The instanced conditions belong to the blueprint, the asset needs its own
+				for(const UDialogueCondition* Condition : TaskOption.ConditionSettings.Conditions)
+				{
+					Option.ConditionSettings.Conditions.Add(Condition ? DuplicateObject(Condition, this) : nullptr);
+				}
+			}
+		}
+
+		for(const UEdGraphPin* Pin : GraphNode->Pins)
+		{
+			if(!DialogueGraph::IsExecOutput(Pin))
+			{
+				continue;
+			}
+
+			if(Script.NotInteractive)
+			{
+				//The other exec pins fire as soon as the node is spawned
+				if(Pin->PinName == GET_MEMBER_NAME_CHECKED(UDialogueTask, DialogueFinished))
+				{
+					Node.NextNode = FindNextNode(Pin, GraphNode->GetName());
+				}
+				continue;
+			}
+
+			const int32 OptionIndex = DialogueGraph::FindOptionIndex(Template, Pin);
+			if(OptionIndex != INDEX_NONE)
+			{
+				const FString Source = FString::Printf(TEXT("%s option %s"), *GraphNode->GetName(), *Pin->PinName.ToString());
+				Options[Node.FirstOption + OptionIndex].NextNode = FindNextNode(Pin, Source);
+			}
+		}
+	}
+
+	for(int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		if(!IsTarget[NodeIndex])
+		{
+			EntryNodes.Add(NodeIndex);
+		}
+	}
+
+	if(EntryNodes.IsEmpty())
+	{
+		OutMessages.Add(TEXT("Every dialogue node is led to by another one, the conversation has no entry node"));
+	}
+
+	return true;
+}
+
+void UDialogueConversation::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	//Cooked conversations are always built from the latest blueprint
+	if(ObjectSaveContext.IsCooking() && !SourceBlueprint.IsNull())
+	{
+		Rebuild();
+	}
+
+	Super::PreSave(ObjectSaveContext);
+}
+#endif
@@ -0,0 +1,75 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "DialogueGraphUtils.h"
+
+#if WITH_EDITOR
+
+#include "DialogueTask.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+
+UDialogueTask* DialogueGraph::FindDialogueTemplate(const UEdGraphNode* GraphNode)
+{
+	for(TFieldIterator<FObjectProperty> It(GraphNode->GetClass()); It; ++It)
+	{
+		if(UDialogueTask* Template = Cast<UDialogueTask>(It->GetObjectPropertyValue_InContainer(GraphNode)))
+		{
+			return Template;
+		}
+	}
+	return nullptr;
+}
+
+bool DialogueGraph::IsExecOutput(const UEdGraphPin* Pin)
+{
+	return Pin->Direction == EGPD_Output && Pin->PinType.PinCategory == TEXT("exec");
+}
+
+int32 DialogueGraph::FindOptionIndex(const UDialogueTask* Template, const UEdGraphPin* Pin)
+{
+	//Option pins are named after their button text, see SelectDialogueOption
+	return Template->Script.DialogueOptions.IndexOfByPredicate([Pin](const FDialogueTaskOption& Option)
+	{
+		return FName(Option.ButtonText.ToString()) == Pin->PinName;
+	});
+}
+
+void DialogueGraph::GatherNextDialogueNodes(const UEdGraphPin* Pin, int32 Hops, TSet<const UEdGraphNode*>& Visited,
+	TArray<TPair<const UEdGraphNode*, UDialogueTask*>>& OutNodes)
+{
+	for(const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+	{
+		const UEdGraphNode* LinkedNode = LinkedPin ? LinkedPin->GetOwningNode() : nullptr;
+		if(!LinkedNode)
+		{
+			continue;
+		}
+
+		bool AlreadyVisited = false;
+		Visited.Add(LinkedNode, &AlreadyVisited);
+		if(AlreadyVisited)
+		{
+			continue;
+		}
+
+		if(UDialogueTask* Template = FindDialogueTemplate(LinkedNode))
+		{
+			OutNodes.Add({LinkedNode, Template});
+			continue;
+		}
+
+		if(Hops < MaxHops)
+		{
+			for(const UEdGraphPin* NodePin : LinkedNode->Pins)
+			{
+				if(IsExecOutput(NodePin))
+				{
+					GatherNextDialogueNodes(NodePin, Hops + 1, Visited, OutNodes);
+				}
+			}
+		}
+	}
+}
+
+#endif
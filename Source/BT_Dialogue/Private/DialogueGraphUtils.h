@@ -0,0 +1,33 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_EDITOR
+
+class UDialogueTask;
+class UEdGraphNode;
+class UEdGraphPin;
+
+/**Helpers for walking dialogue tasks in a blueprint graph.*/
+namespace DialogueGraph
+{
+	/**How many non-dialogue nodes, such as delays or branches,
+	 * are followed between two dialogue nodes. */
+	constexpr int32 MaxHops = 8;
+
+	/**Blueprint task nodes hold the task they spawn as an instanced template.*/
+	UDialogueTask* FindDialogueTemplate(const UEdGraphNode* GraphNode);
+
+	bool IsExecOutput(const UEdGraphPin* Pin);
+
+	/**Index of the dialogue option @Pin triggers, INDEX_NONE if it isn't an option pin.*/
+	int32 FindOptionIndex(const UDialogueTask* Template, const UEdGraphPin* Pin);
+
+	/**Follow @Pin until the first dialogue node on every path.*/
+	void GatherNextDialogueNodes(const UEdGraphPin* Pin, int32 Hops, TSet<const UEdGraphNode*>& Visited,
+		TArray<TPair<const UEdGraphNode*, UDialogueTask*>>& OutNodes);
+}
+
+#endif
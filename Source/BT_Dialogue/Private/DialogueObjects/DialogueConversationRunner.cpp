@@ -0,0 +1,153 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "DialogueObjects/DialogueConversationRunner.h"
+
+#include "Engine/Engine.h"
+#include "Subsystem/DialogueAssetSubsystem.h"
+
+UDialogueConversationRunner* UDialogueConversationRunner::StartConversation(UObject* Outer, UDialogueConversation* Conversation, int32 EntryNode)
+{
+	if(!Outer || !Conversation || Conversation->Nodes.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	if(EntryNode == INDEX_NONE)
+	{
+		EntryNode = Conversation->EntryNodes.IsEmpty() ? 0 : Conversation->EntryNodes[0];
+	}
+
+	if(!Conversation->Nodes.IsValidIndex(EntryNode))
+	{
+		return nullptr;
+	}
+
+	UDialogueConversationRunner* Runner = NewObject<UDialogueConversationRunner>(Outer);
+	Runner->Conversation = Conversation;
+	Runner->EnterNode(EntryNode);
+	return Runner;
+}
+
+FDialogueConversationNode UDialogueConversationRunner::GetCurrentNode() const
+{
+	const FDialogueConversationNode* Node = Conversation ? Conversation->GetNode(CurrentNode) : nullptr;
+	return Node ? *Node : FDialogueConversationNode();
+}
+
+TArray<FDialogueConversationOption> UDialogueConversationRunner::GetCurrentOptions() const
+{
+	return Conversation ? TArray<FDialogueConversationOption>(Conversation->GetNodeOptions(CurrentNode)) : TArray<FDialogueConversationOption>();
+}
+
+FDialogueOptionState UDialogueConversationRunner::GetOptionState(int32 OptionIndex) const
+{
+	return OptionStates.IsValidIndex(OptionIndex) ? OptionStates[OptionIndex] : FDialogueOptionState();
+}
+
+void UDialogueConversationRunner::RefreshOptionStates()
+{
+	const TConstArrayView<FDialogueConversationOption> Options = Conversation ? Conversation->GetNodeOptions(CurrentNode) : TConstArrayView<FDialogueConversationOption>();
+
+	OptionStates.SetNum(Options.Num());
+	for(int32 OptionIndex = 0; OptionIndex < Options.Num(); OptionIndex++)
+	{
+		const FDialogueConditionData& ConditionSettings = Options[OptionIndex].ConditionSettings;
+
+		FDialogueOptionState& State = OptionStates[OptionIndex];
+		State.ConditionsMet = ConditionSettings.AreConditionsMet();
+		State.Enabled = State.ConditionsMet;
+		State.Visible = State.ConditionsMet || !ConditionSettings.HideIfConditionsAreNotMet;
+	}
+}
+
+void UDialogueConversationRunner::SelectOption(int32 OptionIndex)
+{
+	const TConstArrayView<FDialogueConversationOption> Options = Conversation ? Conversation->GetNodeOptions(CurrentNode) : TConstArrayView<FDialogueConversationOption>();
+	if(!Options.IsValidIndex(OptionIndex) || !GetOptionState(OptionIndex).Enabled)
+	{
+		return;
+	}
+
+	Options[OptionIndex].MemorySettings.RecordSelection(this);
+
+	EnterNode(Options[OptionIndex].NextNode);
+}
+
+void UDialogueConversationRunner::Continue()
+{
+	const FDialogueConversationNode* Node = Conversation ? Conversation->GetNode(CurrentNode) : nullptr;
+	if(!Node || !Node->NotInteractive)
+	{
+		return;
+	}
+
+	EnterNode(Node->NextNode);
+}
+
+void UDialogueConversationRunner::Stop()
+{
+	if(!IsRunning())
+	{
+		return;
+	}
+
+	EnterNode(INDEX_NONE);
+}
+
+UWorld* UDialogueConversationRunner::GetWorld() const
+{
+	if(HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return nullptr;
+	}
+
+	return GEngine ? GEngine->GetWorldFromContextObject(GetOuter(), EGetWorldErrorMode::ReturnNull) : nullptr;
+}
+
+void UDialogueConversationRunner::BeginDestroy()
+{
+	ReleaseSpeaker();
+
+	Super::BeginDestroy();
+}
+
+void UDialogueConversationRunner::EnterNode(int32 NodeIndex)
+{
+	const FDialogueConversationNode* Node = Conversation ? Conversation->GetNode(NodeIndex) : nullptr;
+	CurrentNode = Node ? NodeIndex : INDEX_NONE;
+	RefreshOptionStates();
+
+	if(!Node)
+	{
+		ReleaseSpeaker();
+		ConversationFinished.Broadcast();
+		return;
+	}
+
+	//Request the new speaker before releasing the old one, so a speaker that talks again stays loaded
+	UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get();
+	const TSoftObjectPtr<UDialogueCharacter> PreviousSpeaker = RequestedSpeaker;
+	RequestedSpeaker = Node->Character;
+	if(AssetSubsystem)
+	{
+		AssetSubsystem->RequestCharacter(RequestedSpeaker, FOnDialogueCharacterLoaded(), FStreamableManager::AsyncLoadHighPriority);
+		AssetSubsystem->ReleaseCharacter(PreviousSpeaker);
+	}
+
+	NodeEntered.Broadcast(NodeIndex);
+}
+
+void UDialogueConversationRunner::ReleaseSpeaker()
+{
+	if(RequestedSpeaker.IsNull())
+	{
+		return;
+	}
+
+	if(UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get())
+	{
+		AssetSubsystem->ReleaseCharacter(RequestedSpeaker);
+	}
+	RequestedSpeaker = nullptr;
+}
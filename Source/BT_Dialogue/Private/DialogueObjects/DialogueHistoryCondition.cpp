@@ -0,0 +1,48 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "DialogueObjects/DialogueHistoryCondition.h"
+
+#include "Subsystem/DialogueHistorySubsystem.h"
+
+bool UDialogueHistoryCondition::IsConditionMet_Implementation()
+{
+	const UDialogueHistorySubsystem* HistorySubsystem = UDialogueHistorySubsystem::Get(this);
+	const int32 TimesChosen = HistorySubsystem ? HistorySubsystem->TimesChosen(OptionFact) : 0;
+	return (TimesChosen >= MinTimesChosen) != Invert;
+}
+
+void UDialogueHistoryCondition::PostLoad()
+{
+	Super::PostLoad();
+
+	UpdateDependencyTags();
+}
+
+#if WITH_EDITOR
+void UDialogueHistoryCondition::PreEditChange(FProperty* PropertyAboutToChange)
+{
+	Super::PreEditChange(PropertyAboutToChange);
+
+	//The old option is no longer a dependency, the new one is added after the change
+	if(PropertyAboutToChange && PropertyAboutToChange->GetFName() == GET_MEMBER_NAME_CHECKED(UDialogueHistoryCondition, OptionFact))
+	{
+		DependencyTags.RemoveTag(OptionFact);
+	}
+}
+
+void UDialogueHistoryCondition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	UpdateDependencyTags();
+}
+#endif
+
+void UDialogueHistoryCondition::UpdateDependencyTags()
+{
+	if(OptionFact.IsValid())
+	{
+		DependencyTags.AddTag(OptionFact);
+	}
+}
@@ -0,0 +1,260 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "DialogueObjects/DialogueTextRevealer.h"
+
+#include "DialogueTask.h"
+#include "Internationalization/BreakIterator.h"
+
+namespace
+{
+	/**Tags close with "</>", see FDefaultRichTextMarkupParser.*/
+	const TCHAR* RichTextCloseTag = TEXT("</>");
+}
+
+void UDialogueTextRevealer::StartReveal(const FText& Line)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UDialogueTextRevealer::StartReveal)
+
+	FullText = Line;
+	FullString = Line.ToString();
+	BuildRevealEnds();
+
+	//Large enough for the whole line and a closing tag, so revealing never reallocates
+	RevealedBuffer.Reset(FullString.Len() + FCString::Strlen(RichTextCloseTag));
+	RevealedText = FText::GetEmpty();
+	RevealedTextDirty = false;
+	RevealedGraphemes = 0;
+	RevealProgressAccumulator = 0.f;
+	SyncedGraphemesPerSecond = 0.f;
+	FastForwarding = false;
+	Revealing = true;
+
+	if(RevealEnds.IsEmpty())
+	{
+		RevealedText = FullText;
+		FinishReveal(false);
+	}
+}
+
+void UDialogueTextRevealer::StartLine(const FCharacterDialogueText& Line)
+{
+	StartReveal(Line.GetText());
+}
+
+void UDialogueTextRevealer::Skip()
+{
+	if(!Revealing)
+	{
+		return;
+	}
+
+	RevealTo(RevealEnds.Num());
+	FinishReveal(true);
+}
+
+void UDialogueTextRevealer::SyncToDuration(float Seconds)
+{
+	if(!Revealing || Seconds <= 0.f)
+	{
+		return;
+	}
+
+	SyncedGraphemesPerSecond = (RevealEnds.Num() - RevealedGraphemes) / Seconds;
+}
+
+void UDialogueTextRevealer::Stop()
+{
+	Revealing = false;
+	FastForwarding = false;
+	RevealProgressAccumulator = 0.f;
+}
+
+void UDialogueTextRevealer::SetFastForward(bool FastForward)
+{
+	FastForwarding = FastForward;
+}
+
+void UDialogueTextRevealer::SetPaused(bool Paused)
+{
+	IsPaused = Paused;
+}
+
+void UDialogueTextRevealer::SetRevealedGraphemes(int32 Count)
+{
+	RevealTo(Count);
+
+	if(Revealing && RevealedGraphemes == RevealEnds.Num())
+	{
+		FinishReveal(false);
+	}
+}
+
+FText UDialogueTextRevealer::GetRevealedText() const
+{
+	if(RevealedTextDirty)
+	{
+		//The whole line keeps its localization info
+		RevealedText = RevealedGraphemes == RevealEnds.Num() ? FullText : FText::FromString(RevealedBuffer);
+		RevealedTextDirty = false;
+	}
+	return RevealedText;
+}
+
+void UDialogueTextRevealer::Tick(float DeltaTime)
+{
+	const float BaseSpeed = SyncedGraphemesPerSecond > 0.f ? SyncedGraphemesPerSecond : GraphemesPerSecond;
+	const float Speed = BaseSpeed * (FastForwarding ? FastForwardMultiplier : 1.f);
+	if(Speed <= 0.f)
+	{
+		SetRevealedGraphemes(RevealEnds.Num());
+		return;
+	}
+
+	RevealProgressAccumulator += DeltaTime * Speed;
+	const int32 Steps = FMath::FloorToInt32(RevealProgressAccumulator);
+	if(Steps > 0)
+	{
+		RevealProgressAccumulator -= Steps;
+		SetRevealedGraphemes(RevealedGraphemes + Steps);
+	}
+}
+
+bool UDialogueTextRevealer::IsTickable() const
+{
+	return Revealing && !IsPaused && IsValid(this);
+}
+
+TStatId UDialogueTextRevealer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDialogueTextRevealer, STATGROUP_Tickables);
+}
+
+UWorld* UDialogueTextRevealer::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UDialogueTextRevealer::BuildRevealEnds()
+{
+	RevealEnds.Reset();
+	RevealInsideTag.Reset();
+
+	bool InsideTag = false;
+	int32 Index = 0;
+	while(Index < FullString.Len())
+	{
+		const TCHAR Character = FullString[Index];
+
+		if(Character == TEXT('<'))
+		{
+			const int32 TagEnd = FullString.Find(TEXT(">"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index);
+			if(TagEnd != INDEX_NONE)
+			{
+				if(FullString[Index + 1] == TEXT('/'))
+				{
+					InsideTag = false;
+				}
+				else if(FullString[TagEnd - 1] == TEXT('/'))
+				{
+					//Self closing tags are inline decorators such as images, they take one step
+					RevealEnds.Add(TagEnd + 1);
+					RevealInsideTag.Add(InsideTag);
+				}
+				else
+				{
+					InsideTag = true;
+				}
+
+				Index = TagEnd + 1;
+				continue;
+			}
+		}
+
+		if(Character == TEXT('&'))
+		{
+			//Escaped characters such as &lt; are revealed as one
+			const int32 EntityEnd = FullString.Find(TEXT(";"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index);
+			if(EntityEnd != INDEX_NONE && EntityEnd - Index <= 5)
+			{
+				RevealEnds.Add(EntityEnd + 1);
+				RevealInsideTag.Add(InsideTag);
+				Index = EntityEnd + 1;
+				continue;
+			}
+		}
+
+		//Plain text runs until the next tag or escaped character
+		int32 RunEnd = Index + 1;
+		while(RunEnd < FullString.Len() && FullString[RunEnd] != TEXT('<') && FullString[RunEnd] != TEXT('&'))
+		{
+			RunEnd++;
+		}
+
+		AddGraphemes(Index, RunEnd, InsideTag);
+		Index = RunEnd;
+	}
+}
+
+void UDialogueTextRevealer::AddGraphemes(int32 RunStart, int32 RunEnd, bool InsideTag)
+{
+	if(!GraphemeIterator.IsValid())
+	{
+		GraphemeIterator = FBreakIterator::CreateCharacterBoundaryIterator();
+	}
+
+	const int32 RunLength = RunEnd - RunStart;
+	GraphemeIterator->SetString(*FullString + RunStart, RunLength);
+
+	int32 LastBoundary = 0;
+	for(int32 Boundary = GraphemeIterator->MoveToNext(); Boundary != INDEX_NONE && Boundary <= RunLength; Boundary = GraphemeIterator->MoveToNext())
+	{
+		if(Boundary > LastBoundary)
+		{
+			RevealEnds.Add(RunStart + Boundary);
+			RevealInsideTag.Add(InsideTag);
+			LastBoundary = Boundary;
+		}
+	}
+
+	//The end of the run is always a boundary
+	if(LastBoundary < RunLength)
+	{
+		RevealEnds.Add(RunEnd);
+		RevealInsideTag.Add(InsideTag);
+	}
+
+	GraphemeIterator->ClearString();
+}
+
+void UDialogueTextRevealer::RevealTo(int32 Count)
+{
+	Count = FMath::Clamp(Count, 0, RevealEnds.Num());
+	if(Count == RevealedGraphemes)
+	{
+		return;
+	}
+
+	RevealedGraphemes = Count;
+
+	RevealedBuffer.Reset();
+	if(Count > 0)
+	{
+		RevealedBuffer.Append(*FullString, RevealEnds[Count - 1]);
+		if(RevealInsideTag[Count - 1])
+		{
+			RevealedBuffer.Append(RichTextCloseTag);
+		}
+	}
+
+	RevealedTextDirty = true;
+
+	RevealProgress.Broadcast(RevealedGraphemes);
+}
+
+void UDialogueTextRevealer::FinishReveal(bool Skipped)
+{
+	Stop();
+
+	RevealFinished.Broadcast(Skipped);
+}
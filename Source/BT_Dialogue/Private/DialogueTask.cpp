@@ -8,6 +8,146 @@
 #include "Core/FactSubSystem.h"
 #endif
 #include "DataAssets/DialogueCharacter.h"
+#include "Algo/StableSort.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/AudioComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Nodes/TaskGraphNode/TaskGraph.h"
+#include "Sound/SoundBase.h"
+#include "DialogueObjects/DialogueCondition.h"
+#include "DialogueObjects/DialogueTextRevealer.h"
+#include "Subsystem/DialogueAssetSubsystem.h"
+#include "Subsystem/DialogueConditionSubsystem.h"
+#include "Subsystem/DialogueHistorySubsystem.h"
+#include "Subsystem/DialogueSessionSubsystem.h"
+#if WITH_EDITOR
+#include "DialogueGraphUtils.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+#include "Engine/Blueprint.h"
+#endif
+
+static TAutoConsoleVariable<int32> CVarDialoguePrefetchDepth(
+	TEXT("Dialogue.Prefetch.Depth"),
+	2,
+	TEXT("How many dialogue nodes ahead of the active one are streamed in. 0 disables prefetching."));
+
+static TAutoConsoleVariable<int32> CVarDialogueVoiceOverPrerollLines(
+	TEXT("Dialogue.VoiceOver.PrerollLines"),
+	2,
+	TEXT("How many lines after the one being revealed have their voice over streamed in."));
+
+#if WITH_EDITOR
+namespace
+{
+	void GatherPrefetchTargets(const UEdGraphNode* GraphNode, const UDialogueTask* Template, int32 OptionIndex, int32 Depth,
+		TSet<const UEdGraphNode*>& VisitedDialogue, TArray<FDialoguePrefetchTarget>& OutTargets)
+	{
+		for(const UEdGraphPin* Pin : GraphNode->Pins)
+		{
+			if(!DialogueGraph::IsExecOutput(Pin))
+			{
+				continue;
+			}
+
+			//Only the first level is split up per option, deeper nodes inherit it
+			int32 PinOption = OptionIndex;
+			if(Depth == 1 && !Template->Script.NotInteractive)
+			{
+				PinOption = DialogueGraph::FindOptionIndex(Template, Pin);
+				if(PinOption == INDEX_NONE)
+				{
+					continue;
+				}
+			}
+
+			TSet<const UEdGraphNode*> Visited;
+			TArray<TPair<const UEdGraphNode*, UDialogueTask*>> NextNodes;
+			DialogueGraph::GatherNextDialogueNodes(Pin, 0, Visited, NextNodes);
+
+			for(const TPair<const UEdGraphNode*, UDialogueTask*>& NextNode : NextNodes)
+			{
+				bool AlreadyGathered = false;
+				VisitedDialogue.Add(NextNode.Key, &AlreadyGathered);
+				if(AlreadyGathered)
+				{
+					continue;
+				}
+
+				FDialoguePrefetchTarget& Target = OutTargets.AddDefaulted_GetRef();
+				Target.Character = NextNode.Value->Script.Character;
+
+				//Later lines are prerolled once the node is active
+				const TArray<FCharacterDialogueText>& NextLines = NextNode.Value->Script.CharacterDialogue;
+				if(!NextLines.IsEmpty() && !NextLines[0].VoiceOver.IsNull())
+				{
+					Target.Assets.Add(NextLines[0].VoiceOver.ToSoftObjectPath());
+				}
+				Target.OptionIndex = PinOption;
+				Target.Depth = Depth;
+
+				if(Depth < UDialogueTask::MaxPrefetchBakeDepth)
+				{
+					GatherPrefetchTargets(NextNode.Key, NextNode.Value, PinOption, Depth + 1, VisitedDialogue, OutTargets);
+				}
+			}
+		}
+	}
+}
+#endif
+
+bool FDialogueConditionData::AreConditionsMet() const
+{
+	const bool RequireAll = ConditionHandling == EDialogueConditionHandling::AllConditions;
+	bool AnyEvaluated = false;
+
+	for(UDialogueCondition* Condition : Conditions)
+	{
+		if(!Condition)
+		{
+			continue;
+		}
+
+		AnyEvaluated = true;
+		if(Condition->IsConditionMet() != RequireAll)
+		{
+			//First unmet condition fails All, first met condition passes Any
+			return !RequireAll;
+		}
+	}
+
+	//Every condition was met, or there was nothing to check
+	return RequireAll || !AnyEvaluated;
+}
+
+void FDialogueMemoryData::RecordSelection(const UObject* WorldContext) const
+{
+	if(!RememberOptionSelection)
+	{
+		return;
+	}
+
+	#if TAGFACTS_INSTALLED
+	UFactSubSystem* FactSubSystem = UFactSubSystem::Get();
+	FactSubSystem->IncrementFact(OptionFact, 1);
+	#endif
+
+	if(UDialogueHistorySubsystem* HistorySubsystem = UDialogueHistorySubsystem::Get(WorldContext))
+	{
+		HistorySubsystem->RecordChoice(OptionFact);
+	}
+
+	if(UDialogueConditionSubsystem* ConditionSubsystem = UDialogueConditionSubsystem::Get())
+	{
+		ConditionSubsystem->NotifyDependencyChanged(OptionFact);
+	}
+}
+
+uint32 UDialogueTask::TextCacheGeneration = 1;
 
 UDialogueTask::UDialogueTask(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -31,44 +171,488 @@ bool UDialogueTask::Get_NodeTitleColor_Implementation(FLinearColor& Color)
 	return true;
 }
 
-UTexture2D* UDialogueTask::GetSpeakerPortrait()
+#if WITH_EDITOR
+void UDialogueTask::BakePrefetchTargets(const UEdGraphNode* GraphNode)
 {
-	if(Script.Character.IsNull())
+	if(!GraphNode)
 	{
-		return nullptr;
+		return;
+	}
+
+	TArray<FDialoguePrefetchTarget> Targets;
+	TSet<const UEdGraphNode*> VisitedDialogue = {GraphNode};
+	GatherPrefetchTargets(GraphNode, this, INDEX_NONE, 1, VisitedDialogue, Targets);
+
+	//Refreshing a node shouldn't dirty the blueprint unless something changed
+	if(Targets != PrefetchTargets)
+	{
+		Modify();
+		PrefetchTargets = MoveTemp(Targets);
+	}
+}
+
+void UDialogueTask::BakeBlueprintPrefetchTargets(UBlueprint* Blueprint)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UDialogueTask::BakeBlueprintPrefetchTargets)
+
+	if(!Blueprint)
+	{
+		return;
+	}
+
+	TArray<UEdGraph*> Graphs;
+	Graphs.Append(Blueprint->UbergraphPages);
+	Graphs.Append(Blueprint->FunctionGraphs);
+
+	for(const UEdGraph* Graph : Graphs)
+	{
+		if(!Graph)
+		{
+			continue;
+		}
+
+		for(const UEdGraphNode* GraphNode : Graph->Nodes)
+		{
+			if(UDialogueTask* Template = GraphNode ? DialogueGraph::FindDialogueTemplate(GraphNode) : nullptr)
+			{
+				Template->BakePrefetchTargets(GraphNode);
+			}
+		}
+	}
+}
+#endif
+
+void UDialogueTask::Activate_Internal()
+{
+	Super::Activate_Internal();
+
+	UTaskGraph::RegisterWithOwningGraph(this);
+
+	//Script might have been changed since the task was spawned
+	InvalidateTextCache();
+	RequestSpeaker();
+	PrefetchUpcomingNodes();
+
+	RefreshOptionStates();
+	BindConditionDependencies();
+}
+
+void UDialogueTask::Deactivate()
+{
+	ReleaseSpeaker();
+	ReleasePrefetchedNodes();
+	UnbindConditionDependencies();
+	ReleaseSessionWidgets();
+
+	if(TextRevealer)
+	{
+		TextRevealer->Stop();
+	}
+	StopVoiceOver();
+	ReleaseVoiceOver();
+
+	Super::Deactivate();
+}
+
+UUserWidget* UDialogueTask::GetDialogueScreen(TSubclassOf<UUserWidget> ScreenClass)
+{
+	UDialogueSessionSubsystem* SessionSubsystem = UDialogueSessionSubsystem::Get(this);
+	return SessionSubsystem ? SessionSubsystem->AcquireScreen(ScreenClass) : nullptr;
+}
+
+UUserWidget* UDialogueTask::AcquireOptionWidget(TSubclassOf<UUserWidget> WidgetClass)
+{
+	UDialogueSessionSubsystem* SessionSubsystem = UDialogueSessionSubsystem::Get(this);
+	UUserWidget* Widget = SessionSubsystem ? SessionSubsystem->AcquireOptionWidget(WidgetClass) : nullptr;
+	if(Widget)
+	{
+		OptionWidgets.Add(Widget);
 	}
+	return Widget;
+}
 
-	if(Script.Character.LoadSynchronous()->CharacterPortrait.IsNull())
+void UDialogueTask::ReleaseSessionWidgets()
+{
+	UDialogueSessionSubsystem* SessionSubsystem = UDialogueSessionSubsystem::Get(this);
+	if(SessionSubsystem)
+	{
+		for(UUserWidget* Widget : OptionWidgets)
+		{
+			SessionSubsystem->ReleaseOptionWidget(Widget);
+		}
+
+		if(RemoveDialogueScreenOnDeactivate)
+		{
+			SessionSubsystem->ReleaseScreen();
+		}
+	}
+	OptionWidgets.Reset();
+}
+
+UDialogueTextRevealer* UDialogueTask::RevealDialogueLine(int32 LineIndex)
+{
+	if(!Script.CharacterDialogue.IsValidIndex(LineIndex))
 	{
 		return nullptr;
 	}
-	
-	return Cast<UTexture2D>(Script.Character->CharacterPortrait.LoadSynchronous());
+
+	if(!TextRevealer)
+	{
+		TextRevealer = NewObject<UDialogueTextRevealer>(this);
+		TextRevealer->RevealFinished.AddDynamic(this, &UDialogueTask::OnLineRevealFinished);
+	}
+
+	RevealedLineIndex = LineIndex;
+	TextRevealer->StartLine(Script.CharacterDialogue[LineIndex]);
+
+	StopVoiceOver();
+	PrerollVoiceOver(LineIndex);
+	StartVoiceOver(LineIndex);
+
+	return TextRevealer;
 }
 
-TArray<FCustomOutputPin> UDialogueTask::Get_CustomOutputPins_Implementation() const
+bool UDialogueTask::SkipDialogueLine()
 {
-	TArray<FCustomOutputPin> Output;
+	if(!TextRevealer || !TextRevealer->IsRevealing())
+	{
+		return false;
+	}
 
-	if(Script.NotInteractive)
+	TextRevealer->Skip();
+	return true;
+}
+
+void UDialogueTask::OnLineRevealFinished(bool Skipped)
+{
+	LineRevealed.Broadcast(RevealedLineIndex, Skipped);
+}
+
+void UDialogueTask::PrerollVoiceOver(int32 LineIndex)
+{
+	const int32 LastLine = LineIndex + FMath::Max(0, CVarDialogueVoiceOverPrerollLines.GetValueOnGameThread());
+
+	//Lines that have been spoken are released one by one, so long conversations don't keep every sound
+	for(auto It = VoiceOverHandles.CreateIterator(); It; ++It)
 	{
-		return Output;
+		if(It.Key() < LineIndex || It.Key() > LastLine)
+		{
+			if(It.Value().IsValid())
+			{
+				It.Value()->ReleaseHandle();
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	for(int32 PrerollIndex = LineIndex; PrerollIndex <= LastLine && Script.CharacterDialogue.IsValidIndex(PrerollIndex); PrerollIndex++)
+	{
+		const TSoftObjectPtr<USoundBase>& VoiceOver = Script.CharacterDialogue[PrerollIndex].VoiceOver;
+		if(VoiceOver.IsNull() || VoiceOverHandles.Contains(PrerollIndex))
+		{
+			continue;
+		}
+
+		VoiceOverHandles.Add(PrerollIndex, UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			VoiceOver.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &UDialogueTask::OnVoiceOverLoaded, PrerollIndex),
+			PrerollIndex == LineIndex ? FStreamableManager::AsyncLoadHighPriority : FStreamableManager::DefaultAsyncLoadPriority));
+	}
+}
+
+void UDialogueTask::ReleaseVoiceOver()
+{
+	for(TPair<int32, TSharedPtr<FStreamableHandle>>& Handle : VoiceOverHandles)
+	{
+		if(Handle.Value.IsValid())
+		{
+			Handle.Value->ReleaseHandle();
+		}
+	}
+	VoiceOverHandles.Reset();
+}
+
+void UDialogueTask::OnVoiceOverLoaded(int32 LineIndex)
+{
+	//Only the line being revealed is played, prerolled lines wait for their turn
+	if(Get_IsActive() && LineIndex == RevealedLineIndex)
+	{
+		StartVoiceOver(LineIndex);
+	}
+}
+
+void UDialogueTask::StartVoiceOver(int32 LineIndex)
+{
+	if(VoiceOverLineIndex == LineIndex || !Script.CharacterDialogue.IsValidIndex(LineIndex))
+	{
+		return;
+	}
+
+	USoundBase* Sound = Script.CharacterDialogue[LineIndex].VoiceOver.Get();
+	if(!Sound)
+	{
+		//Not loaded yet, OnVoiceOverLoaded starts it
+		return;
+	}
+
+	VoiceOverLineIndex = LineIndex;
+
+	//Without an audio device no component is spawned, the reveal is still timed to the sound
+	VoiceOverComponent = UGameplayStatics::SpawnSound2D(this, Sound);
+
+	const float Duration = Sound->GetDuration();
+	if(TextRevealer && Duration > 0.f && Duration < INDEFINITELY_LOOPING_DURATION)
+	{
+		TextRevealer->SyncToDuration(Duration);
+	}
+}
+
+void UDialogueTask::StopVoiceOver()
+{
+	//Spawned sounds destroy themselves once they finish
+	if(IsValid(VoiceOverComponent))
+	{
+		VoiceOverComponent->Stop();
+	}
+	VoiceOverComponent = nullptr;
+	VoiceOverLineIndex = INDEX_NONE;
+}
+
+UTexture2D* UDialogueTask::GetSpeakerPortrait()
+{
+	//Only active tasks hold on to their speaker
+	if(Get_IsActive() && Script.Character != RequestedSpeaker)
+	{
+		RequestSpeaker();
+	}
+
+	if(UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get())
+	{
+		return AssetSubsystem->GetLoadedPortrait(Script.Character);
+	}
+
+	return nullptr;
+}
+
+void UDialogueTask::RequestSpeaker()
+{
+	ReleaseSpeaker();
+
+	UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get();
+	if(!AssetSubsystem || Script.Character.IsNull())
+	{
+		return;
+	}
+
+	RequestedSpeaker = Script.Character;
+	AssetSubsystem->RequestCharacter(RequestedSpeaker,
+		FOnDialogueCharacterLoaded::CreateUObject(this, &UDialogueTask::OnSpeakerLoaded),
+		FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UDialogueTask::ReleaseSpeaker()
+{
+	if(RequestedSpeaker.IsNull())
+	{
+		return;
+	}
+
+	if(UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get())
+	{
+		AssetSubsystem->ReleaseCharacter(RequestedSpeaker);
+	}
+	RequestedSpeaker = nullptr;
+}
+
+FDialogueOptionState UDialogueTask::GetOptionState(int32 OptionIndex) const
+{
+	return OptionStates.IsValidIndex(OptionIndex) ? OptionStates[OptionIndex] : FDialogueOptionState();
+}
+
+void UDialogueTask::RefreshOptionStates()
+{
+	const int32 OptionCount = Script.DialogueOptions.Num();
+	const bool FirstEvaluation = OptionStates.Num() != OptionCount;
+	OptionStates.SetNum(OptionCount);
+
+	for(int32 OptionIndex = 0; OptionIndex < OptionCount; OptionIndex++)
+	{
+		if(UpdateOptionState(OptionIndex) && !FirstEvaluation)
+		{
+			OptionStateChanged.Broadcast(OptionIndex, OptionStates[OptionIndex]);
+		}
+	}
+}
+
+bool UDialogueTask::UpdateOptionState(int32 OptionIndex)
+{
+	const FDialogueConditionData& ConditionSettings = Script.DialogueOptions[OptionIndex].ConditionSettings;
+
+	FDialogueOptionState NewState;
+	NewState.ConditionsMet = ConditionSettings.AreConditionsMet();
+	NewState.Enabled = NewState.ConditionsMet;
+	NewState.Visible = NewState.ConditionsMet || !ConditionSettings.HideIfConditionsAreNotMet;
+
+	if(OptionStates[OptionIndex] == NewState)
+	{
+		return false;
+	}
+
+	OptionStates[OptionIndex] = NewState;
+	return true;
+}
+
+void UDialogueTask::BindConditionDependencies()
+{
+	UnbindConditionDependencies();
+
+	bool HasDependencies = false;
+	OptionDependencies.SetNum(Script.DialogueOptions.Num());
+	for(int32 OptionIndex = 0; OptionIndex < Script.DialogueOptions.Num(); OptionIndex++)
+	{
+		FGameplayTagContainer& Dependencies = OptionDependencies[OptionIndex];
+		Dependencies.Reset();
+		for(const UDialogueCondition* Condition : Script.DialogueOptions[OptionIndex].ConditionSettings.Conditions)
+		{
+			if(Condition)
+			{
+				Dependencies.AppendTags(Condition->DependencyTags);
+			}
+		}
+		HasDependencies |= !Dependencies.IsEmpty();
+	}
+
+	UDialogueConditionSubsystem* ConditionSubsystem = UDialogueConditionSubsystem::Get();
+	if(HasDependencies && ConditionSubsystem)
+	{
+		DependencyChangedHandle = ConditionSubsystem->OnDependencyChanged.AddUObject(this, &UDialogueTask::OnDependencyChanged);
+	}
+}
+
+void UDialogueTask::UnbindConditionDependencies()
+{
+	if(!DependencyChangedHandle.IsValid())
+	{
+		return;
+	}
+
+	if(UDialogueConditionSubsystem* ConditionSubsystem = UDialogueConditionSubsystem::Get())
+	{
+		ConditionSubsystem->OnDependencyChanged.Remove(DependencyChangedHandle);
+	}
+	DependencyChangedHandle.Reset();
+}
+
+void UDialogueTask::OnDependencyChanged(const FGameplayTag& ChangedTag)
+{
+	for(int32 OptionIndex = 0; OptionIndex < OptionDependencies.Num() && OptionStates.IsValidIndex(OptionIndex); OptionIndex++)
+	{
+		//Only options that read the changed state are evaluated again
+		if(OptionDependencies[OptionIndex].IsEmpty() || (ChangedTag.IsValid() && !ChangedTag.MatchesAny(OptionDependencies[OptionIndex])))
+		{
+			continue;
+		}
+
+		if(UpdateOptionState(OptionIndex))
+		{
+			OptionStateChanged.Broadcast(OptionIndex, OptionStates[OptionIndex]);
+		}
+	}
+}
+
+void UDialogueTask::PrefetchUpcomingNodes()
+{
+	const int32 MaxDepth = CVarDialoguePrefetchDepth.GetValueOnGameThread();
+	UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get();
+	if(MaxDepth <= 0 || !AssetSubsystem || PrefetchTargets.IsEmpty())
+	{
+		return;
 	}
 
-	for(auto& DialogueOption : Script.DialogueOptions)
+	//Nearest nodes first, so the budget is spent on what comes up soonest
+	TArray<const FDialoguePrefetchTarget*> Targets;
+	for(const FDialoguePrefetchTarget& Target : PrefetchTargets)
 	{
-		FString ToolTipText;
-		for(int32 i = 0; i < DialogueOption.DialogueTexts.Num(); i++)
+		if(Target.Depth <= MaxDepth)
 		{
-			ToolTipText += "- " + DialogueOption.DialogueTexts[i].DialogueText.ToString();
-			if(DialogueOption.DialogueTexts.IsValidIndex(i + 1))
+			Targets.Add(&Target);
+		}
+	}
+	Algo::StableSortBy(Targets, [](const FDialoguePrefetchTarget* Target) { return Target->Depth; });
+
+	//Out of budget, everything further away can wait
+	for(const FDialoguePrefetchTarget* Target : Targets)
+	{
+		if(!Target->Assets.IsEmpty())
+		{
+			TSharedPtr<FStreamableHandle> Handle = AssetSubsystem->PrefetchAssets(Target->Assets);
+			if(!Handle.IsValid())
 			{
-				ToolTipText += LINE_TERMINATOR;
-				ToolTipText += LINE_TERMINATOR;
+				break;
 			}
+			PrefetchHandles.Add(MoveTemp(Handle));
+		}
+
+		if(Target->Character.IsNull() || Target->Character == Script.Character || PrefetchedCharacters.Contains(Target->Character))
+		{
+			continue;
 		}
-		
-		Output.Add(FCustomOutputPin(DialogueOption.ButtonText.ToString(), ToolTipText));
+
+		if(!AssetSubsystem->PrefetchCharacter(Target->Character))
+		{
+			break;
+		}
+		PrefetchedCharacters.Add(Target->Character);
+	}
+}
+
+void UDialogueTask::ReleasePrefetchedNodes()
+{
+	if(UDialogueAssetSubsystem* AssetSubsystem = UDialogueAssetSubsystem::Get())
+	{
+		for(const TSoftObjectPtr<UDialogueCharacter>& Character : PrefetchedCharacters)
+		{
+			AssetSubsystem->ReleasePrefetchedCharacter(Character);
+		}
+	}
+	PrefetchedCharacters.Reset();
+
+	for(TSharedPtr<FStreamableHandle>& Handle : PrefetchHandles)
+	{
+		if(Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+	PrefetchHandles.Reset();
+}
+
+void UDialogueTask::OnSpeakerLoaded(UDialogueCharacter* Character)
+{
+	//The speaker might have changed while it was loading
+	if(!Character || Character != RequestedSpeaker.Get())
+	{
+		return;
+	}
+
+	PortraitReady.Broadcast(Character->CharacterPortrait.Get());
+}
+
+TArray<FCustomOutputPin> UDialogueTask::Get_CustomOutputPins_Implementation() const
+{
+	TArray<FCustomOutputPin> Output;
+
+	if(Script.NotInteractive)
+	{
+		return Output;
+	}
+
+	BuildTextCache();
+
+	Output.Reserve(Script.DialogueOptions.Num());
+	for(int32 OptionIndex = 0; OptionIndex < Script.DialogueOptions.Num(); OptionIndex++)
+	{
+		Output.Add(FCustomOutputPin(Script.DialogueOptions[OptionIndex].ButtonText.ToString(), CachedOptionTooltips[OptionIndex]));
 	}
 	
 	return Output;
@@ -76,13 +660,7 @@ TArray<FCustomOutputPin> UDialogueTask::Get_CustomOutputPins_Implementation() co
 
 void UDialogueTask::SelectDialogueOption(FDialogueTaskOption Option)
 {
-	#if TAGFACTS_INSTALLED
-	if(Option.MemorySettings.RememberOptionSelection)
-	{
-		UFactSubSystem* FactSubSystem = UFactSubSystem::Get();
-		FactSubSystem->IncrementFact(Option.MemorySettings.OptionFact, 1);
-	}
-	#endif
+	Option.MemorySettings.RecordSelection(this);
 
 	TriggerCustomOutputPin(FName(Option.ButtonText.ToString()), TInstancedStruct<FCustomOutputPinData>::Make<FDialogueTaskOption>(Option));
 }
@@ -104,7 +682,7 @@ TArray<FString> UDialogueTask::ValidateNodeDuringCompilation_Implementation()
 	{
 		for(int32 i = 0; i < Script.CharacterDialogue.Num(); i++)
 		{
-			if(Script.CharacterDialogue[i].DialogueText.IsEmpty())
+			if(!Script.CharacterDialogue[i].HasText())
 			{
 				Errors.Add(FString::Printf(TEXT("Character Dialogue index %i does not contain text"), i));
 			}
@@ -131,7 +709,7 @@ TArray<FString> UDialogueTask::ValidateNodeDuringCompilation_Implementation()
 
 			for(int32 DialogueTextIndex = 0; DialogueTextIndex < Script.DialogueOptions[i].DialogueTexts.Num(); DialogueTextIndex++)
 			{
-				if(Script.DialogueOptions[i].DialogueTexts[DialogueTextIndex].DialogueText.IsEmpty())
+				if(!Script.DialogueOptions[i].DialogueTexts[DialogueTextIndex].HasText())
 				{
 					Errors.Add(FString::Printf(TEXT("Dialogue index %i, option %i does not contain dialogue text"), i, DialogueTextIndex));
 				}
@@ -160,17 +738,78 @@ TArray<FString> UDialogueTask::ValidateNodeDuringCompilation_Implementation()
 
 FString UDialogueTask::GetCenterText_Implementation()
 {
-	FString FinalText;
-	for(int32 i = 0; i < Script.CharacterDialogue.Num(); i++)
+	BuildTextCache();
+	return CachedCenterText;
+}
+
+FText UDialogueTask::GetDialogueLine(int32 LineIndex) const
+{
+	return Script.CharacterDialogue.IsValidIndex(LineIndex) ? Script.CharacterDialogue[LineIndex].GetText() : FText::GetEmpty();
+}
+
+void UDialogueTask::InvalidateTextCache()
+{
+	CachedTextGeneration = 0;
+}
+
+void UDialogueTask::InvalidateAllTextCaches()
+{
+	//Skip 0, that's what invalidated tasks hold
+	if(++TextCacheGeneration == 0)
+	{
+		TextCacheGeneration = 1;
+	}
+}
+
+#if WITH_EDITOR
+void UDialogueTask::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	InvalidateTextCache();
+}
+
+void UDialogueTask::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	InvalidateTextCache();
+}
+#endif
+
+void UDialogueTask::BuildTextCache() const
+{
+	//Options added at runtime without invalidating would otherwise go out of range
+	if(CachedTextGeneration == TextCacheGeneration && CachedOptionTooltips.Num() == Script.DialogueOptions.Num())
 	{
-		FinalText += "- " + Script.CharacterDialogue[i].DialogueText.ToString();
-		/**Check if this is the last index. If it isn't, add two line breaks */
-		if(Script.CharacterDialogue.IsValidIndex(i + 1))
+		return;
+	}
+
+	TStringBuilder<512> Builder;
+
+	AppendDialogueLines(Builder, Script.CharacterDialogue);
+	CachedCenterText = Builder.ToString();
+
+	CachedOptionTooltips.SetNum(Script.DialogueOptions.Num());
+	for(int32 OptionIndex = 0; OptionIndex < Script.DialogueOptions.Num(); OptionIndex++)
+	{
+		Builder.Reset();
+		AppendDialogueLines(Builder, Script.DialogueOptions[OptionIndex].DialogueTexts);
+		CachedOptionTooltips[OptionIndex] = Builder.ToString();
+	}
+
+	CachedTextGeneration = TextCacheGeneration;
+}
+
+void UDialogueTask::AppendDialogueLines(FStringBuilderBase& Builder, const TArray<FCharacterDialogueText>& Lines)
+{
+	for(int32 LineIndex = 0; LineIndex < Lines.Num(); LineIndex++)
+	{
+		//Lines are separated by an empty line
+		if(LineIndex > 0)
 		{
-			FinalText += LINE_TERMINATOR;
-			FinalText += LINE_TERMINATOR;
+			Builder << LINE_TERMINATOR << LINE_TERMINATOR;
 		}
+		Builder << TEXT("- ") << Lines[LineIndex].GetText().ToString();
 	}
-	return FinalText;
 }
-
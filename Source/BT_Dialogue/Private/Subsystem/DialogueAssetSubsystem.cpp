@@ -0,0 +1,317 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/DialogueAssetSubsystem.h"
+
+#include "DataAssets/DialogueCharacter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarDialogueCharacterCacheSize(
+	TEXT("Dialogue.CharacterCacheSize"),
+	16,
+	TEXT("How many dialogue characters and portraits are kept loaded after no dialogue uses them anymore."));
+
+static TAutoConsoleVariable<float> CVarDialoguePrefetchBudgetMB(
+	TEXT("Dialogue.Prefetch.BudgetMB"),
+	64.f,
+	TEXT("Megabytes of portraits that may be loaded ahead of time for upcoming dialogue nodes."));
+
+namespace
+{
+	/**Resident assets report their memory, loads still in flight
+	 * are estimated by the size of their package on disk. */
+	int64 GetPrefetchSize(const FSoftObjectPath& Path)
+	{
+		if(const UObject* Asset = Path.ResolveObject())
+		{
+			return Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+
+		const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry
+			? AssetRegistry->GetAssetPackageDataCopy(Path.GetLongPackageFName())
+			: TOptional<FAssetPackageData>();
+		return PackageData.IsSet() ? FMath::Max<int64>(PackageData->DiskSize, 0) : 0;
+	}
+}
+
+UDialogueAssetSubsystem* UDialogueAssetSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UDialogueAssetSubsystem>() : nullptr;
+}
+
+void UDialogueAssetSubsystem::Deinitialize()
+{
+	for(TPair<FSoftObjectPath, FDialogueCharacterCacheEntry>& Entry : Entries)
+	{
+		ReleaseEntry(Entry.Value);
+	}
+	Entries.Empty();
+	AssetPrefetches.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDialogueAssetSubsystem::RequestCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character, FOnDialogueCharacterLoaded OnLoaded, TAsyncLoadPriority Priority)
+{
+	if(Character.IsNull())
+	{
+		return;
+	}
+
+	const FSoftObjectPath CharacterPath = Character.ToSoftObjectPath();
+	FDialogueCharacterCacheEntry& Entry = Entries.FindOrAdd(CharacterPath);
+	Entry.Users++;
+	Entry.LastUsed = ++UseCounter;
+
+	if(Entry.Loaded)
+	{
+		OnLoaded.ExecuteIfBound(Character.Get());
+		return;
+	}
+
+	if(OnLoaded.IsBound())
+	{
+		Entry.PendingCallbacks.Add(MoveTemp(OnLoaded));
+	}
+
+	if(Entry.CharacterHandle.IsValid())
+	{
+		//Already streaming
+		return;
+	}
+
+	/**The portrait is only known once the character is loaded,
+	 * so it's streamed in a second request. */
+	Entry.CharacterHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		CharacterPath,
+		FStreamableDelegate::CreateUObject(this, &UDialogueAssetSubsystem::OnCharacterLoaded, CharacterPath, Priority),
+		Priority);
+}
+
+void UDialogueAssetSubsystem::ReleaseCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character)
+{
+	FDialogueCharacterCacheEntry* Entry = Entries.Find(Character.ToSoftObjectPath());
+	if(!Entry || Entry->Users <= 0)
+	{
+		return;
+	}
+
+	Entry->Users--;
+	if(Entry->Users == 0)
+	{
+		TrimCache();
+	}
+}
+
+bool UDialogueAssetSubsystem::PrefetchCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character)
+{
+	if(Character.IsNull())
+	{
+		return false;
+	}
+
+	//Characters that are already around cost nothing extra
+	if(!Entries.Contains(Character.ToSoftObjectPath()) && IsPrefetchBudgetSpent())
+	{
+		return false;
+	}
+
+	RequestCharacter(Character, FOnDialogueCharacterLoaded(), FStreamableManager::DefaultAsyncLoadPriority - 50);
+	Entries.FindChecked(Character.ToSoftObjectPath()).PrefetchUsers++;
+	return true;
+}
+
+void UDialogueAssetSubsystem::ReleasePrefetchedCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character)
+{
+	FDialogueCharacterCacheEntry* Entry = Entries.Find(Character.ToSoftObjectPath());
+	if(!Entry || Entry->PrefetchUsers <= 0)
+	{
+		return;
+	}
+
+	Entry->PrefetchUsers--;
+	ReleaseCharacter(Character);
+}
+
+TSharedPtr<FStreamableHandle> UDialogueAssetSubsystem::PrefetchAssets(const TArray<FSoftObjectPath>& Assets)
+{
+	if(Assets.IsEmpty() || IsPrefetchBudgetSpent())
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		Assets,
+		FStreamableDelegate(),
+		FStreamableManager::DefaultAsyncLoadPriority - 50);
+
+	if(Handle.IsValid())
+	{
+		AssetPrefetches.RemoveAll([](const TWeakPtr<FStreamableHandle>& Prefetch)
+		{
+			const TSharedPtr<FStreamableHandle> PinnedPrefetch = Prefetch.Pin();
+			return !PinnedPrefetch.IsValid() || !PinnedPrefetch->IsActive();
+		});
+		AssetPrefetches.Add(Handle);
+	}
+	return Handle;
+}
+
+int64 UDialogueAssetSubsystem::GetPrefetchedBytes() const
+{
+	int64 Bytes = 0;
+	for(const TPair<FSoftObjectPath, FDialogueCharacterCacheEntry>& Entry : Entries)
+	{
+		if(Entry.Value.PrefetchUsers == 0 || Entry.Value.Users > Entry.Value.PrefetchUsers)
+		{
+			continue;
+		}
+
+		/**The portrait is only known once the character is resident,
+		 * until then the character's own package is all there is to go by. */
+		const UDialogueCharacter* Character = Cast<UDialogueCharacter>(Entry.Key.ResolveObject());
+		if(!Character)
+		{
+			Bytes += GetPrefetchSize(Entry.Key);
+		}
+		else if(!Character->CharacterPortrait.IsNull())
+		{
+			Bytes += GetPrefetchSize(Character->CharacterPortrait.ToSoftObjectPath());
+		}
+	}
+
+	for(const TWeakPtr<FStreamableHandle>& Prefetch : AssetPrefetches)
+	{
+		const TSharedPtr<FStreamableHandle> PinnedPrefetch = Prefetch.Pin();
+		if(!PinnedPrefetch.IsValid() || !PinnedPrefetch->IsActive())
+		{
+			continue;
+		}
+
+		for(const FSoftObjectPath& Asset : PinnedPrefetch->GetRequestedAssets())
+		{
+			Bytes += GetPrefetchSize(Asset);
+		}
+	}
+	return Bytes;
+}
+
+bool UDialogueAssetSubsystem::IsPrefetchBudgetSpent() const
+{
+	const int64 BudgetBytes = static_cast<int64>(CVarDialoguePrefetchBudgetMB.GetValueOnGameThread() * 1024.f * 1024.f);
+	return GetPrefetchedBytes() >= BudgetBytes;
+}
+
+UTexture2D* UDialogueAssetSubsystem::GetLoadedPortrait(TSoftObjectPtr<UDialogueCharacter> Character) const
+{
+	const UDialogueCharacter* LoadedCharacter = Character.Get();
+	return LoadedCharacter ? LoadedCharacter->CharacterPortrait.Get() : nullptr;
+}
+
+bool UDialogueAssetSubsystem::IsCharacterLoaded(TSoftObjectPtr<UDialogueCharacter> Character) const
+{
+	const FDialogueCharacterCacheEntry* Entry = Entries.Find(Character.ToSoftObjectPath());
+	return Entry && Entry->Loaded;
+}
+
+void UDialogueAssetSubsystem::OnCharacterLoaded(FSoftObjectPath CharacterPath, TAsyncLoadPriority Priority)
+{
+	FDialogueCharacterCacheEntry* Entry = Entries.Find(CharacterPath);
+	if(!Entry)
+	{
+		return;
+	}
+
+	const UDialogueCharacter* Character = Cast<UDialogueCharacter>(CharacterPath.ResolveObject());
+	if(!Character || Character->CharacterPortrait.IsNull() || Character->CharacterPortrait.Get())
+	{
+		OnPortraitLoaded(CharacterPath);
+		return;
+	}
+
+	Entry->PortraitHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		Character->CharacterPortrait.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &UDialogueAssetSubsystem::OnPortraitLoaded, CharacterPath),
+		Priority);
+}
+
+void UDialogueAssetSubsystem::OnPortraitLoaded(FSoftObjectPath CharacterPath)
+{
+	FDialogueCharacterCacheEntry* Entry = Entries.Find(CharacterPath);
+	if(!Entry)
+	{
+		return;
+	}
+
+	Entry->Loaded = true;
+
+	//Callbacks might request or release characters, which can reallocate the entries
+	TArray<FOnDialogueCharacterLoaded> Callbacks = MoveTemp(Entry->PendingCallbacks);
+	Entry->PendingCallbacks.Reset();
+
+	UDialogueCharacter* Character = Cast<UDialogueCharacter>(CharacterPath.ResolveObject());
+	for(FOnDialogueCharacterLoaded& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound(Character);
+	}
+}
+
+void UDialogueAssetSubsystem::TrimCache()
+{
+	const int32 MaxCachedCharacters = FMath::Max(0, CVarDialogueCharacterCacheSize.GetValueOnGameThread());
+
+	int32 Unused = 0;
+	for(const TPair<FSoftObjectPath, FDialogueCharacterCacheEntry>& Entry : Entries)
+	{
+		if(Entry.Value.Users == 0)
+		{
+			Unused++;
+		}
+	}
+
+	while(Unused > MaxCachedCharacters)
+	{
+		const FSoftObjectPath* Oldest = nullptr;
+		uint64 OldestUse = TNumericLimits<uint64>::Max();
+		for(const TPair<FSoftObjectPath, FDialogueCharacterCacheEntry>& Entry : Entries)
+		{
+			if(Entry.Value.Users == 0 && Entry.Value.LastUsed < OldestUse)
+			{
+				Oldest = &Entry.Key;
+				OldestUse = Entry.Value.LastUsed;
+			}
+		}
+
+		if(!Oldest)
+		{
+			break;
+		}
+
+		const FSoftObjectPath OldestPath = *Oldest;
+		FDialogueCharacterCacheEntry Evicted;
+		Entries.RemoveAndCopyValue(OldestPath, Evicted);
+		ReleaseEntry(Evicted);
+		Unused--;
+	}
+}
+
+void UDialogueAssetSubsystem::ReleaseEntry(FDialogueCharacterCacheEntry& Entry)
+{
+	//Loads still in flight are released once they complete, their callbacks find no entry
+	if(Entry.PortraitHandle.IsValid())
+	{
+		Entry.PortraitHandle->ReleaseHandle();
+	}
+
+	if(Entry.CharacterHandle.IsValid())
+	{
+		Entry.CharacterHandle->ReleaseHandle();
+	}
+
+	Entry.PendingCallbacks.Reset();
+}
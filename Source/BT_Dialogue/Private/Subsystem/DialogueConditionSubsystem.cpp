@@ -0,0 +1,66 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/DialogueConditionSubsystem.h"
+
+#include "Engine/Engine.h"
+
+#if TAGFACTS_INSTALLED
+#include "Core/FactSubSystem.h"
+#endif
+
+UDialogueConditionSubsystem* UDialogueConditionSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UDialogueConditionSubsystem>() : nullptr;
+}
+
+void UDialogueConditionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	#if TAGFACTS_INSTALLED
+	Collection.InitializeDependency<UFactSubSystem>();
+	if(UFactSubSystem* FactSubSystem = UFactSubSystem::Get())
+	{
+		FactSubSystem->OnFactUpdated.AddDynamic(this, &UDialogueConditionSubsystem::OnFactUpdated);
+	}
+	#endif
+}
+
+void UDialogueConditionSubsystem::Deinitialize()
+{
+	#if TAGFACTS_INSTALLED
+	if(UFactSubSystem* FactSubSystem = UFactSubSystem::Get())
+	{
+		FactSubSystem->OnFactUpdated.RemoveDynamic(this, &UDialogueConditionSubsystem::OnFactUpdated);
+	}
+	#endif
+
+	Super::Deinitialize();
+}
+
+void UDialogueConditionSubsystem::OnFactUpdated(FGameplayTag Fact, int32 NewValue)
+{
+	NotifyDependencyChanged(Fact);
+}
+
+void UDialogueConditionSubsystem::NotifyDependencyChanged(FGameplayTag Tag)
+{
+	if(Tag.IsValid())
+	{
+		OnDependencyChanged.Broadcast(Tag);
+	}
+}
+
+void UDialogueConditionSubsystem::NotifyAllDependenciesChanged()
+{
+	OnDependencyChanged.Broadcast(FGameplayTag::EmptyTag);
+}
+
+void UDialogueConditionSubsystem::NotifyDependenciesChanged(const FGameplayTagContainer& Tags)
+{
+	for(const FGameplayTag& Tag : Tags)
+	{
+		NotifyDependencyChanged(Tag);
+	}
+}
@@ -0,0 +1,60 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/DialogueHistorySubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/Crc.h"
+#include "Subsystem/DialogueConditionSubsystem.h"
+
+UDialogueHistorySubsystem* UDialogueHistorySubsystem::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UDialogueHistorySubsystem>() : nullptr;
+}
+
+uint32 UDialogueHistorySubsystem::GetOptionID(const FGameplayTag& OptionFact)
+{
+	//FName hashes aren't stable between sessions, the tag's string is
+	return FCrc::StrCrc32(*OptionFact.ToString());
+}
+
+void UDialogueHistorySubsystem::RecordChoice(const FGameplayTag& OptionFact)
+{
+	if(!OptionFact.IsValid())
+	{
+		return;
+	}
+
+	History.TimesChosen.FindOrAdd(GetOptionID(OptionFact))++;
+}
+
+int32 UDialogueHistorySubsystem::TimesChosen(FGameplayTag OptionFact) const
+{
+	if(!OptionFact.IsValid())
+	{
+		return 0;
+	}
+
+	const int32* Count = History.TimesChosen.Find(GetOptionID(OptionFact));
+	return Count ? *Count : 0;
+}
+
+void UDialogueHistorySubsystem::SetHistory(const FDialogueHistory& NewHistory)
+{
+	History = NewHistory;
+
+	//Can't tell which options changed, every history condition has to check again
+	if(UDialogueConditionSubsystem* ConditionSubsystem = UDialogueConditionSubsystem::Get())
+	{
+		ConditionSubsystem->NotifyAllDependenciesChanged();
+	}
+}
+
+void UDialogueHistorySubsystem::ClearHistory()
+{
+	SetHistory(FDialogueHistory());
+}
@@ -0,0 +1,62 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/DialogueLineStore.h"
+
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Internationalization/Internationalization.h"
+#include "Internationalization/StringTableCoreFwd.h"
+
+static TAutoConsoleVariable<int32> CVarDialogueLineCacheSize(
+	TEXT("Dialogue.LineCacheSize"),
+	1024,
+	TEXT("How many resolved dialogue lines are kept in memory. Applied the next time the cache is flushed."));
+
+UDialogueLineStore::UDialogueLineStore()
+	: ResolvedLines(CVarDialogueLineCacheSize.GetValueOnAnyThread())
+{
+}
+
+UDialogueLineStore* UDialogueLineStore::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UDialogueLineStore>() : nullptr;
+}
+
+void UDialogueLineStore::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FlushCache();
+	CultureChangedHandle = FInternationalization::Get().OnCultureChanged().AddUObject(this, &UDialogueLineStore::FlushCache);
+}
+
+void UDialogueLineStore::Deinitialize()
+{
+	FInternationalization::Get().OnCultureChanged().Remove(CultureChangedHandle);
+	ResolvedLines.Empty();
+
+	Super::Deinitialize();
+}
+
+FText UDialogueLineStore::ResolveLine(FDialogueLineID LineID)
+{
+	if(!LineID.IsValid())
+	{
+		return FText::GetEmpty();
+	}
+
+	if(const FText* ResolvedLine = ResolvedLines.FindAndTouch(LineID))
+	{
+		return *ResolvedLine;
+	}
+
+	FText Line = FText::FromStringTable(LineID.TableID, LineID.Key.ToString(), EStringTableLoadingPolicy::FindOrFullyLoad);
+	ResolvedLines.Add(LineID, Line);
+	return Line;
+}
+
+void UDialogueLineStore::FlushCache()
+{
+	ResolvedLines.Empty(FMath::Max(1, CVarDialogueLineCacheSize.GetValueOnGameThread()));
+}
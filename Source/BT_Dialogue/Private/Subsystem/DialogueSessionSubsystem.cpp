@@ -0,0 +1,136 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/DialogueSessionSubsystem.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarDialogueOptionWidgetPoolSize(
+	TEXT("Dialogue.OptionWidgetPoolSize"),
+	8,
+	TEXT("How many released option widgets are kept per widget class for the next dialogue node."));
+
+UDialogueSessionSubsystem* UDialogueSessionSubsystem::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UDialogueSessionSubsystem>() : nullptr;
+}
+
+void UDialogueSessionSubsystem::Deinitialize()
+{
+	if(Screen)
+	{
+		Screen->RemoveFromParent();
+		Screen = nullptr;
+	}
+	OptionWidgetPools.Empty();
+
+	Super::Deinitialize();
+}
+
+UUserWidget* UDialogueSessionSubsystem::AcquireScreen(TSubclassOf<UUserWidget> ScreenClass, APlayerController* OwningPlayer, int32 ZOrder)
+{
+	if(!ScreenClass)
+	{
+		return nullptr;
+	}
+
+	if(!OwningPlayer)
+	{
+		OwningPlayer = GetWorld()->GetFirstPlayerController();
+	}
+
+	if(Screen && (Screen->GetClass() != ScreenClass || (OwningPlayer && Screen->GetOwningPlayer() != OwningPlayer)))
+	{
+		Screen->RemoveFromParent();
+		Screen = nullptr;
+	}
+
+	if(!Screen)
+	{
+		Screen = OwningPlayer ? CreateWidget<UUserWidget>(OwningPlayer, ScreenClass) : CreateWidget<UUserWidget>(GetWorld(), ScreenClass);
+		if(!Screen)
+		{
+			return nullptr;
+		}
+		Stats.ScreensCreated++;
+	}
+
+	if(!Screen->IsInViewport())
+	{
+		Screen->AddToViewport(ZOrder);
+	}
+
+	return Screen;
+}
+
+void UDialogueSessionSubsystem::ReleaseScreen()
+{
+	if(Screen)
+	{
+		Screen->RemoveFromParent();
+	}
+}
+
+UUserWidget* UDialogueSessionSubsystem::AcquireOptionWidget(TSubclassOf<UUserWidget> WidgetClass)
+{
+	if(!WidgetClass)
+	{
+		return nullptr;
+	}
+
+	UUserWidget* Widget = nullptr;
+	if(FDialogueWidgetPool* Pool = OptionWidgetPools.Find(WidgetClass))
+	{
+		//Widgets might have been destroyed along with their owning player
+		while(!Widget && !Pool->FreeWidgets.IsEmpty())
+		{
+			Widget = Pool->FreeWidgets.Pop(EAllowShrinking::No);
+			Stats.OptionWidgetsPooled--;
+		}
+	}
+
+	if(!Widget)
+	{
+		APlayerController* OwningPlayer = Screen ? Screen->GetOwningPlayer() : GetWorld()->GetFirstPlayerController();
+		Widget = OwningPlayer ? CreateWidget<UUserWidget>(OwningPlayer, WidgetClass) : CreateWidget<UUserWidget>(GetWorld(), WidgetClass);
+		if(!Widget)
+		{
+			return nullptr;
+		}
+		Stats.OptionWidgetsCreated++;
+	}
+
+	Stats.OptionWidgetsAcquired++;
+	Stats.OptionWidgetsInUse++;
+	return Widget;
+}
+
+void UDialogueSessionSubsystem::ReleaseOptionWidget(UUserWidget* Widget)
+{
+	if(!Widget)
+	{
+		return;
+	}
+
+	Widget->RemoveFromParent();
+	Stats.OptionWidgetsInUse = FMath::Max(0, Stats.OptionWidgetsInUse - 1);
+
+	FDialogueWidgetPool& Pool = OptionWidgetPools.FindOrAdd(Widget->GetClass());
+	if(Pool.FreeWidgets.Num() < CVarDialogueOptionWidgetPoolSize.GetValueOnGameThread() && !Pool.FreeWidgets.Contains(Widget))
+	{
+		Pool.FreeWidgets.Add(Widget);
+		Stats.OptionWidgetsPooled++;
+	}
+}
+
+void UDialogueSessionSubsystem::ResetStats()
+{
+	Stats.ScreensCreated = 0;
+	Stats.OptionWidgetsCreated = 0;
+	Stats.OptionWidgetsAcquired = 0;
+}
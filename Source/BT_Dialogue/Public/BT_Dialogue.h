@@ -3,9 +3,17 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogDialogue, Log, All);
+
 class FBT_DialogueModule : public IModuleInterface
 {
 public:
     virtual void StartupModule() override;
     virtual void ShutdownModule() override;
+
+private:
+
+    FDelegateHandle CultureChangedHandle;
+
+    FDelegateHandle BlueprintPreCompileHandle;
 };
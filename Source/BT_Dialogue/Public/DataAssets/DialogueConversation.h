@@ -0,0 +1,135 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DialogueTask.h"
+#include "Developer/I_AssetDetails.h"
+#include "Engine/DataAsset.h"
+#include "DialogueConversation.generated.h"
+
+class UBlueprint;
+
+USTRUCT(BlueprintType)
+struct FDialogueConversationOption
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	FText ButtonText;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	TArray<FCharacterDialogueText> DialogueTexts;
+
+	/**Conditions are copied into the conversation asset.*/
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	FDialogueConditionData ConditionSettings;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	FDialogueMemoryData MemorySettings;
+
+	/**Index of the node this option leads to. INDEX_NONE if the conversation
+	 * ends here, or continues into blueprint logic that can't be flattened. */
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	int32 NextNode = INDEX_NONE;
+};
+
+USTRUCT(BlueprintType)
+struct FDialogueConversationNode
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	TSoftObjectPtr<UDialogueCharacter> Character = nullptr;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	TArray<FCharacterDialogueText> CharacterDialogue;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	EDialogueType DialogueType = EDialogueType::FullScreen;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	bool NotInteractive = false;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	float FinishDelay = 0.4;
+
+	/**This node's options are Options[FirstOption] to Options[FirstOption + OptionCount - 1].*/
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	int32 FirstOption = 0;
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	int32 OptionCount = 0;
+
+	/**The node after this one, for nodes that aren't interactive.*/
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	int32 NextNode = INDEX_NONE;
+
+	/**Name of the graph node this was flattened from.*/
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere)
+	FName SourceNode;
+};
+
+/**
+ * A conversation flattened out of the dialogue tasks in a blueprint.
+ * The blueprint stays the authoring format. The flattened tables are
+ * rebuilt whenever the asset is cooked, or through Rebuild.
+ *
+ * Played back by a UDialogueConversationRunner, which doesn't need a
+ * task object per node. Only what happens between dialogue nodes is
+ * lost: delays and branches are skipped, and options that lead into
+ * other blueprint logic end the conversation.
+ */
+UCLASS(BlueprintType)
+class BT_DIALOGUE_API UDialogueConversation : public UPrimaryDataAsset, public II_AssetDetails
+{
+	GENERATED_BODY()
+
+public:
+
+#if WITH_EDITORONLY_DATA
+	/**Blueprint the conversation is flattened from.*/
+	UPROPERTY(Category = "Conversation", EditAnywhere)
+	TSoftObjectPtr<UBlueprint> SourceBlueprint = nullptr;
+#endif
+
+	UPROPERTY(Category = "Conversation", VisibleAnywhere, BlueprintReadOnly)
+	TArray<FDialogueConversationNode> Nodes;
+
+	UPROPERTY(Category = "Conversation", VisibleAnywhere, BlueprintReadOnly)
+	TArray<FDialogueConversationOption> Options;
+
+	/**Nodes no other dialogue node leads to, where the conversation can start.*/
+	UPROPERTY(Category = "Conversation", VisibleAnywhere, BlueprintReadOnly)
+	TArray<int32> EntryNodes;
+
+	const FDialogueConversationNode* GetNode(int32 NodeIndex) const
+	{
+		return Nodes.IsValidIndex(NodeIndex) ? &Nodes[NodeIndex] : nullptr;
+	}
+
+	TConstArrayView<FDialogueConversationOption> GetNodeOptions(int32 NodeIndex) const;
+
+#if WITH_EDITOR
+	/**Flatten SourceBlueprint again.*/
+	UFUNCTION(Category = "Conversation", CallInEditor)
+	void Rebuild();
+
+	/**Flatten every dialogue task in @Blueprint into the node and option tables.
+	 * Problems found along the way are added to @OutMessages.
+	 * Returns false if the blueprint has no dialogue tasks. */
+	bool BuildFromBlueprint(UBlueprint* Blueprint, TArray<FString>& OutMessages);
+
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+
+	virtual bool AppearsInContextMenu_Implementation() const override
+	{
+		return GetClass() == UDialogueConversation::StaticClass();
+	}
+
+	virtual TArray<FText> GetAssetsCategories_Implementation() const override
+	{
+		return { FText::FromString("Dialogue System") };
+	}
+};
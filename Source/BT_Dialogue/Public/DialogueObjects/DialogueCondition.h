@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
 #include "Developer/I_AssetDetails.h"
 #include "UObject/Object.h"
 #include "DialogueCondition.generated.h"
@@ -20,6 +21,17 @@ public:
 	UFUNCTION(Category = "Dialogue", BlueprintCallable, BlueprintPure, BlueprintNativeEvent)
 	bool IsConditionMet();
 
+	/**The state this condition reads, for example the facts it checks.
+	 * The result is cached by the dialogue task and only evaluated again
+	 * when UDialogueConditionSubsystem is notified that one of these tags,
+	 * or a child of them, has changed.
+	 * TagFacts changes are forwarded automatically, quests are covered
+	 * through their quest and objective ID facts. Other state has to
+	 * call NotifyDependencyChanged itself.
+	 * Without any tags, the condition is evaluated once per activation. */
+	UPROPERTY(Category = "Dependencies", EditAnywhere, BlueprintReadOnly)
+	FGameplayTagContainer DependencyTags;
+
 	virtual UWorld* GetWorld() const override;
 	
 	virtual FLinearColor GetAssetColor_Implementation() const override
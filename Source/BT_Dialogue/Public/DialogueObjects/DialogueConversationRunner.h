@@ -0,0 +1,100 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DataAssets/DialogueConversation.h"
+#include "UObject/Object.h"
+#include "DialogueConversationRunner.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDialogueConversationNodeEntered, int32, NodeIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDialogueConversationFinished);
+
+/**
+ * Plays a UDialogueConversation without spawning a dialogue task
+ * per node. The runner only tracks where the conversation is,
+ * showing it is up to whoever listens to NodeEntered, including
+ * waiting out the node's FinishDelay before calling SelectOption
+ * or Continue.
+ */
+UCLASS(BlueprintType)
+class BT_DIALOGUE_API UDialogueConversationRunner : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**Start @Conversation at @EntryNode, or at its first entry node if INDEX_NONE.*/
+	UFUNCTION(Category = "Dialogue", BlueprintCallable, meta = (DefaultToSelf = "Outer"))
+	static UDialogueConversationRunner* StartConversation(UObject* Outer, UDialogueConversation* Conversation, int32 EntryNode = -1);
+
+	UPROPERTY(BlueprintAssignable)
+	FDialogueConversationNodeEntered NodeEntered;
+
+	UPROPERTY(BlueprintAssignable)
+	FDialogueConversationFinished ConversationFinished;
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	UDialogueConversation* GetConversation() const
+	{
+		return Conversation;
+	}
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	bool IsRunning() const
+	{
+		return CurrentNode != INDEX_NONE;
+	}
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	int32 GetCurrentNodeIndex() const
+	{
+		return CurrentNode;
+	}
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	FDialogueConversationNode GetCurrentNode() const;
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	TArray<FDialogueConversationOption> GetCurrentOptions() const;
+
+	/**Condition results of the current node's options,
+	 * evaluated when the node was entered. */
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	FDialogueOptionState GetOptionState(int32 OptionIndex) const;
+
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void RefreshOptionStates();
+
+	/**Choose one of the current node's options. Ignored if
+	 * the option is out of range or its conditions aren't met. */
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void SelectOption(int32 OptionIndex);
+
+	/**Move past a node that isn't interactive.*/
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void Continue();
+
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void Stop();
+
+	virtual UWorld* GetWorld() const override;
+
+	virtual void BeginDestroy() override;
+
+private:
+
+	UPROPERTY()
+	TObjectPtr<UDialogueConversation> Conversation = nullptr;
+
+	int32 CurrentNode = INDEX_NONE;
+
+	TArray<FDialogueOptionState> OptionStates;
+
+	/**The speaker held in the UDialogueAssetSubsystem.*/
+	TSoftObjectPtr<UDialogueCharacter> RequestedSpeaker = nullptr;
+
+	void EnterNode(int32 NodeIndex);
+
+	void ReleaseSpeaker();
+};
@@ -0,0 +1,46 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DialogueCondition.h"
+#include "DialogueHistoryCondition.generated.h"
+
+/**
+ * Met depending on how often the player has chosen a remembered
+ * dialogue option, read from the UDialogueHistorySubsystem.
+ */
+UCLASS(DisplayName = "Dialogue History Condition")
+class BT_DIALOGUE_API UDialogueHistoryCondition : public UDialogueCondition
+{
+	GENERATED_BODY()
+
+public:
+
+	/**The OptionFact of the remembered option.*/
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadOnly)
+	FGameplayTag OptionFact;
+
+	/**How often the option must have been chosen for the condition to be met.*/
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = 1))
+	int32 MinTimesChosen = 1;
+
+	/**Met if the option has NOT been chosen MinTimesChosen times.*/
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadOnly)
+	bool Invert = false;
+
+	virtual bool IsConditionMet_Implementation() override;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PreEditChange(FProperty* PropertyAboutToChange) override;
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+
+	/**The option is what this condition depends on.*/
+	void UpdateDependencyTags();
+};
@@ -0,0 +1,168 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/Object.h"
+#include "DialogueTextRevealer.generated.h"
+
+class IBreakIterator;
+struct FCharacterDialogueText;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDialogueRevealProgress, int32, RevealedGraphemes);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDialogueRevealFinished, bool, Skipped);
+
+/**
+ * Reveals a dialogue line one grapheme at a time, typewriter style.
+ *
+ * The line is split into graphemes once when it's set, so revealing
+ * only has to cut the line at a precomputed offset. Rich text tags
+ * take no time to reveal, and a tag that is cut off is closed, so the
+ * revealed text can be shown in a URichTextBlock as is.
+ *
+ * The revealed text is only rebuilt when another grapheme is revealed,
+ * into a buffer that is reserved for the whole line. Widgets that can
+ * take a string should read GetRevealedString, GetRevealedText has to
+ * build an FText the first time it's called after each reveal step.
+ */
+UCLASS(BlueprintType)
+class BT_DIALOGUE_API UDialogueTextRevealer : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**Graphemes revealed per second.*/
+	UPROPERTY(Category = "Dialogue|Reveal", EditAnywhere, BlueprintReadWrite)
+	float GraphemesPerSecond = 40.f;
+
+	/**Reveal speed multiplier while fast forwarding.*/
+	UPROPERTY(Category = "Dialogue|Reveal", EditAnywhere, BlueprintReadWrite)
+	float FastForwardMultiplier = 4.f;
+
+	/**Broadcast whenever more of the line has been revealed.*/
+	UPROPERTY(BlueprintAssignable)
+	FDialogueRevealProgress RevealProgress;
+
+	/**Broadcast once the whole line is revealed,
+	 * with Skipped set if Skip cut it short. */
+	UPROPERTY(BlueprintAssignable)
+	FDialogueRevealFinished RevealFinished;
+
+	/**Set the line to reveal and start revealing it from the beginning.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void StartReveal(const FText& Line);
+
+	/**Start revealing a dialogue line, resolved through the UDialogueLineStore if needed.*/
+	void StartLine(const FCharacterDialogueText& Line);
+
+	/**Reveal the rest of the line right away.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void Skip();
+
+	/**Reveal the rest of the line over @Seconds instead of at GraphemesPerSecond,
+	 * for example to keep it in sync with a voice line. Cleared by the next line. */
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void SyncToDuration(float Seconds);
+
+	/**Stop revealing without finishing the line.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void Stop();
+
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void SetFastForward(bool FastForward);
+
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void SetPaused(bool Paused);
+
+	/**Reveal exactly @Count graphemes, for example to drive the reveal from an animation.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	void SetRevealedGraphemes(int32 Count);
+
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	int32 GetRevealedGraphemes() const
+	{
+		return RevealedGraphemes;
+	}
+
+	/**Visible graphemes in the line, not counting rich text tags.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	int32 GetGraphemeCount() const
+	{
+		return RevealEnds.Num();
+	}
+
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	bool IsRevealing() const
+	{
+		return Revealing;
+	}
+
+	/**Built from the revealed string on first use after each reveal step.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	FText GetRevealedText() const;
+
+	/**The revealed part of the line, valid until the next grapheme is revealed.
+	 * Prefer this over GetRevealedText, it never allocates. */
+	FStringView GetRevealedString() const
+	{
+		return RevealedBuffer;
+	}
+
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	FText GetFullText() const
+	{
+		return FullText;
+	}
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+private:
+
+	FText FullText;
+
+	FString FullString;
+
+	/**Offset in FullString after each visible grapheme.*/
+	TArray<int32> RevealEnds;
+
+	/**Whether a rich text tag is still open after each visible grapheme.*/
+	TBitArray<> RevealInsideTag;
+
+	FString RevealedBuffer;
+
+	mutable FText RevealedText;
+
+	/**RevealedText is behind RevealedBuffer.*/
+	mutable bool RevealedTextDirty = false;
+
+	int32 RevealedGraphemes = 0;
+
+	/**Speed set by SyncToDuration, 0 if the line uses GraphemesPerSecond.*/
+	float SyncedGraphemesPerSecond = 0.f;
+
+	/**Fraction of the next grapheme that has been revealed.*/
+	float RevealProgressAccumulator = 0.f;
+
+	bool Revealing = false;
+
+	bool FastForwarding = false;
+
+	bool IsPaused = false;
+
+	TSharedPtr<IBreakIterator> GraphemeIterator;
+
+	/**Find every grapheme in FullString, skipping rich text tags.*/
+	void BuildRevealEnds();
+
+	void AddGraphemes(int32 RunStart, int32 RunEnd, bool InsideTag);
+
+	/**Reveal @Count graphemes and broadcast the progress, without finishing the line.*/
+	void RevealTo(int32 Count);
+
+	void FinishReveal(bool Skipped);
+};
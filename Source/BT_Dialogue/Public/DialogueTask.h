@@ -6,11 +6,19 @@
 #include "BtfTaskForge.h"
 #include "GameplayTagContainer.h"
 #include "Developer/I_AssetDetails.h"
+#include "Subsystem/DialogueLineStore.h"
 
 #include "DialogueTask.generated.h"
 
 class UDialogueCondition;
 class UDialogueCharacter;
+class UDialogueTextRevealer;
+class UAudioComponent;
+class UBlueprint;
+class UEdGraphNode;
+class USoundBase;
+class UUserWidget;
+struct FStreamableHandle;
 
 UENUM(BlueprintType)
 enum class EDialogueConditionHandling : uint8
@@ -27,7 +35,7 @@ enum class EDialogueType : uint8
 };
 
 USTRUCT(BlueprintType)
-struct FDialogueConditionData
+struct BT_DIALOGUE_API FDialogueConditionData
 {
 	GENERATED_BODY()
 
@@ -41,30 +49,63 @@ struct FDialogueConditionData
 	 * be met?*/
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Instanced, Category = "Dialogue Option")
 	TArray<UDialogueCondition*> Conditions;
+
+	/**Whether one or all of the conditions have to be met.
+	 * Conditions are evaluated in order and stop as soon as the result is known. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dialogue Option")
+	EDialogueConditionHandling ConditionHandling = EDialogueConditionHandling::AllConditions;
+
+	/**Evaluate the conditions, honouring ConditionHandling.
+	 * Null conditions are skipped, no conditions at all counts as met. */
+	bool AreConditionsMet() const;
 };
 
+/**Cached result of an option's conditions.*/
 USTRUCT(BlueprintType)
-struct FDialogueMemoryData
+struct FDialogueOptionState
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	bool ConditionsMet = true;
+
+	/**False if the conditions aren't met and the option wants to be hidden.*/
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	bool Visible = true;
+
+	/**Options that are visible but not enabled should be greyed out.*/
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	bool Enabled = true;
+
+	bool operator==(const FDialogueOptionState& Other) const
+	{
+		return ConditionsMet == Other.ConditionsMet && Visible == Other.Visible && Enabled == Other.Enabled;
+	}
+};
+
+USTRUCT(BlueprintType)
+struct BT_DIALOGUE_API FDialogueMemoryData
 {
 	GENERATED_BODY()
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool RememberOptionSelection = false;
 
-	/**If @RememberOptionSelection is true, AND TagFacts is installed,
-	 * we will increment a fact with this tag by 1 to remember how
-	 * often this option has been selected.
-	 * If you don't have TagFacts installed, you must implement your
-	 * own solution for storing this dialogue option in your
-	 * own database. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "!RememberOptionSelection"))
+	/**Identifies this option if @RememberOptionSelection is true.
+	 * Every selection is recorded in the UDialogueHistorySubsystem,
+	 * which UDialogueHistoryCondition reads.
+	 * If TagFacts is installed, a fact with this tag is also
+	 * incremented by 1. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "RememberOptionSelection"))
 	FGameplayTag OptionFact;
+
+	/**Remember that the option was selected, if RememberOptionSelection is set.*/
+	void RecordSelection(const UObject* WorldContext) const;
 };
 
-/**V: For now, this is just a text field. It's being handled
- * this way so in the case of us wanting to expand this,
- * for example adding audio, we won't have to do any
- * PostLoad shenanigans. */
+/**V: It's being handled this way so in the case of us
+ * wanting to expand this, for example adding audio,
+ * we won't have to do any PostLoad shenanigans. */
 USTRUCT(BlueprintType)
 struct FCharacterDialogueText
 {
@@ -72,6 +113,35 @@ struct FCharacterDialogueText
 
 	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadWrite, meta = (MultiLine = "true"))
 	FText DialogueText = FText();
+
+	/**If set, the line is resolved from a string table through the
+	 * UDialogueLineStore when it's shown and DialogueText can be left
+	 * empty. Large games should prefer this, so dialogue graphs don't
+	 * have to carry the text of every line. */
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadWrite)
+	FDialogueLineID LineID;
+
+	/**Optional voice line. Streamed in shortly before the line is shown,
+	 * and the line's text is revealed over the length of the sound. */
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<USoundBase> VoiceOver = nullptr;
+
+	bool HasText() const
+	{
+		return LineID.IsValid() || !DialogueText.IsEmpty();
+	}
+
+	FText GetText() const
+	{
+		if(LineID.IsValid())
+		{
+			if(UDialogueLineStore* LineStore = UDialogueLineStore::Get())
+			{
+				return LineStore->ResolveLine(LineID);
+			}
+		}
+		return DialogueText;
+	}
 };
 
 USTRUCT(BlueprintType)
@@ -131,7 +201,39 @@ struct FDialogueScript
 	EDialogueType DialogueType = EDialogueType::FullScreen;
 };
 
+/**A dialogue node that can follow this one, found when the node is edited.*/
+USTRUCT(BlueprintType)
+struct FDialoguePrefetchTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	TSoftObjectPtr<UDialogueCharacter> Character = nullptr;
+
+	/**Other assets the node needs, such as voice lines.*/
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	TArray<FSoftObjectPath> Assets;
+
+	/**The option that leads to the node, INDEX_NONE
+	 * if the dialogue isn't interactive. */
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	int32 OptionIndex = INDEX_NONE;
+
+	/**1 for the nodes directly after this one.*/
+	UPROPERTY(Category = "Dialogue", VisibleAnywhere, BlueprintReadOnly)
+	int32 Depth = 1;
+
+	bool operator==(const FDialoguePrefetchTarget& Other) const
+	{
+		return Character == Other.Character && Assets == Other.Assets
+			&& OptionIndex == Other.OptionIndex && Depth == Other.Depth;
+	}
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDialogueFinished);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDialoguePortraitReady, UTexture2D*, Portrait);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDialogueLineRevealed, int32, LineIndex, bool, Skipped);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDialogueOptionStateChanged, int32, OptionIndex, FDialogueOptionState, State);
 
 /**
  * A task that is responsible for handling interactive dialogue
@@ -155,17 +257,133 @@ public:
 	UPROPERTY(BlueprintAssignable, BlueprintCallable)
 	FDialogueFinished DialogueFinished;
 
+	/**Broadcast once the speaker and their portrait have been streamed in.
+	 * If they were already loaded, this is broadcast during activation. */
+	UPROPERTY(BlueprintAssignable)
+	FDialoguePortraitReady PortraitReady;
+
 	/**Set this to true if the dialogue screen
 	 * is supposed to be removed when this
-	 * dialogue task is finished.*/
+	 * dialogue task is finished.
+	 * Leave it off for every node but the last one of a conversation,
+	 * so consecutive nodes share the same screen.*/
 	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadWrite)
 	bool RemoveDialogueScreenOnDeactivate = false;
 
+	/**The dialogue screen shared by consecutive dialogue tasks,
+	 * created through the UDialogueSessionSubsystem if there is none yet. */
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable, meta = (DeterminesOutputType = "ScreenClass"))
+	UUserWidget* GetDialogueScreen(TSubclassOf<UUserWidget> ScreenClass);
+
+	/**A pooled widget for an option button. It's handed back
+	 * to the pool when this task is deactivated. */
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable, meta = (DeterminesOutputType = "WidgetClass"))
+	UUserWidget* AcquireOptionWidget(TSubclassOf<UUserWidget> WidgetClass);
+
 	virtual bool Get_NodeTitleColor_Implementation(FLinearColor& Color) override;
 
+	/**The character's lines as one string. Built once and cached
+	 * until the script is edited, the culture changes or the task
+	 * is activated again. */
 	UFUNCTION(BlueprintNativeEvent)
 	FString GetCenterText();
 
+	/**Drop the cached center text and pin tooltips.
+	 * Call this after changing Script on an active task. */
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void InvalidateTextCache();
+
+	/**Invalidates the text caches of every dialogue task.*/
+	static void InvalidateAllTextCaches();
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+
+	/**Broadcast when an option's conditions change result after activation,
+	 * so the UI can show, hide, enable or disable its button. */
+	UPROPERTY(BlueprintAssignable)
+	FDialogueOptionStateChanged OptionStateChanged;
+
+	/**Cached condition results of the option at @OptionIndex in Script.DialogueOptions.
+	 * Evaluated on activation and kept up to date through the UDialogueConditionSubsystem. */
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	FDialogueOptionState GetOptionState(int32 OptionIndex) const;
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	TArray<FDialogueOptionState> GetOptionStates() const
+	{
+		return OptionStates;
+	}
+
+	/**Evaluate every option's conditions again, ignoring the cache.*/
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void RefreshOptionStates();
+
+	/**Dialogue nodes reachable from this one and what they need loaded,
+	 * gathered from the graph whenever the blueprint is compiled.
+	 * While this node is active, the targets up to Dialogue.Prefetch.Depth
+	 * are streamed in so the next line can be shown without waiting. */
+	UPROPERTY(Category = "Dialogue|Prefetch", VisibleAnywhere, AdvancedDisplay)
+	TArray<FDialoguePrefetchTarget> PrefetchTargets;
+
+#if WITH_EDITOR
+	/**How many nodes deep PrefetchTargets looks.*/
+	static constexpr int32 MaxPrefetchBakeDepth = 3;
+
+	/**Walk the graph from @GraphNode's output pins and refresh PrefetchTargets.*/
+	void BakePrefetchTargets(const UEdGraphNode* GraphNode);
+
+	/**Refresh PrefetchTargets of every dialogue node in @Blueprint.
+	 * Runs before the blueprint compiles, so the generated class
+	 * picks up the baked node templates. */
+	static void BakeBlueprintPrefetchTargets(UBlueprint* Blueprint);
+#endif
+
+	virtual void Activate_Internal() override;
+
+	virtual void Deactivate() override;
+
+	/**Text of the line at @LineIndex in Script.CharacterDialogue,
+	 * resolved through the UDialogueLineStore if it uses a line ID. */
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	FText GetDialogueLine(int32 LineIndex) const;
+
+	/**Start revealing the line at @LineIndex in Script.CharacterDialogue
+	 * through this task's text revealer, and return the revealer so the
+	 * UI can bind to its progress.
+	 * The line's voice over is played once it's loaded, and the voice
+	 * over of the next Dialogue.VoiceOver.PrerollLines lines is streamed in. */
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	UDialogueTextRevealer* RevealDialogueLine(int32 LineIndex);
+
+	/**Skip the line that is being revealed. Returns false if it was
+	 * already fully revealed, so the same input can move on instead. */
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintCallable)
+	bool SkipDialogueLine();
+
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	UDialogueTextRevealer* GetTextRevealer() const
+	{
+		return TextRevealer;
+	}
+
+	/**Null while no voice over is playing, or if there is no audio device.*/
+	UFUNCTION(Category = "Dialogue|Reveal", BlueprintPure)
+	UAudioComponent* GetVoiceOverComponent() const
+	{
+		return IsValid(VoiceOverComponent) ? VoiceOverComponent : nullptr;
+	}
+
+	/**Broadcast when a line started through RevealDialogueLine is fully revealed.*/
+	UPROPERTY(BlueprintAssignable)
+	FDialogueLineRevealed LineRevealed;
+
+	/**Returns null until the portrait has been streamed in,
+	 * bind to PortraitReady to know when it's available.
+	 * If Script.Character has changed while the task is active,
+	 * the new speaker is streamed in. */
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	UTexture2D* GetSpeakerPortrait();
 
@@ -190,4 +408,92 @@ public:
 	{
 		return { FText::FromString("Dialogue System") };
 	}
+
+private:
+
+	/**The speaker held in the UDialogueAssetSubsystem, released on deactivation.*/
+	TSoftObjectPtr<UDialogueCharacter> RequestedSpeaker = nullptr;
+
+	void RequestSpeaker();
+
+	void ReleaseSpeaker();
+
+	void OnSpeakerLoaded(UDialogueCharacter* Character);
+
+	UPROPERTY(Transient)
+	TObjectPtr<UDialogueTextRevealer> TextRevealer = nullptr;
+
+	int32 RevealedLineIndex = INDEX_NONE;
+
+	UFUNCTION()
+	void OnLineRevealFinished(bool Skipped);
+
+	UPROPERTY(Transient)
+	TObjectPtr<UAudioComponent> VoiceOverComponent = nullptr;
+
+	/**The line VoiceOverComponent was started for.*/
+	int32 VoiceOverLineIndex = INDEX_NONE;
+
+	/**Voice over being streamed in or held, per line in Script.CharacterDialogue.*/
+	TMap<int32, TSharedPtr<FStreamableHandle>> VoiceOverHandles;
+
+	/**Stream in the voice over of @LineIndex and the lines after it,
+	 * and release the lines that are out of that window. */
+	void PrerollVoiceOver(int32 LineIndex);
+
+	void ReleaseVoiceOver();
+
+	void OnVoiceOverLoaded(int32 LineIndex);
+
+	void StartVoiceOver(int32 LineIndex);
+
+	void StopVoiceOver();
+
+	/**Option widgets taken from the UDialogueSessionSubsystem.*/
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UUserWidget>> OptionWidgets;
+
+	void ReleaseSessionWidgets();
+
+	mutable FString CachedCenterText;
+
+	/**One per dialogue option.*/
+	mutable TArray<FString> CachedOptionTooltips;
+
+	/**Caches built for an older generation are stale.*/
+	mutable uint32 CachedTextGeneration = 0;
+
+	/**Bumped whenever every cache has to be rebuilt, such as on a culture change.
+	 * Starts at 1 so a fresh task never counts as cached. */
+	static uint32 TextCacheGeneration;
+
+	void BuildTextCache() const;
+
+	static void AppendDialogueLines(FStringBuilderBase& Builder, const TArray<FCharacterDialogueText>& Lines);
+
+	TArray<FDialogueOptionState> OptionStates;
+
+	/**Union of the DependencyTags of each option's conditions.*/
+	TArray<FGameplayTagContainer> OptionDependencies;
+
+	FDelegateHandle DependencyChangedHandle;
+
+	/**Returns true if the state changed.*/
+	bool UpdateOptionState(int32 OptionIndex);
+
+	void BindConditionDependencies();
+
+	void UnbindConditionDependencies();
+
+	void OnDependencyChanged(const FGameplayTag& ChangedTag);
+
+	/**Characters held in the UDialogueAssetSubsystem for upcoming nodes.*/
+	TArray<TSoftObjectPtr<UDialogueCharacter>> PrefetchedCharacters;
+
+	/**Other assets of upcoming nodes, one handle per node.*/
+	TArray<TSharedPtr<FStreamableHandle>> PrefetchHandles;
+
+	void PrefetchUpcomingNodes();
+
+	void ReleasePrefetchedNodes();
 };
@@ -40,7 +40,10 @@ class BT_DIALOGUE_API UDialogueTaskDecorator : public UBtf_NodeDecorator
 
 	virtual TSharedRef<SWidget> CreateCenterContent(UClass* TaskClass, UBtf_TaskForge* BlueprintTaskNode, UEdGraphNode* GraphNode) override
 	{
-		Portrait = Cast<UDialogueTask>(BlueprintTaskNode)->GetSpeakerPortrait();
+		/**The editor can afford a blocking load, at runtime
+		 * portraits are streamed by the UDialogueAssetSubsystem. */
+		const UDialogueCharacter* Character = Cast<UDialogueTask>(BlueprintTaskNode)->Script.Character.LoadSynchronous();
+		Portrait = Character ? Character->CharacterPortrait.LoadSynchronous() : nullptr;
 		if(Portrait)
 		{
 			Brush.SetImageSize(FVector2D(64));
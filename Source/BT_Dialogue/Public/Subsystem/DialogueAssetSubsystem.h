@@ -0,0 +1,112 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "DialogueAssetSubsystem.generated.h"
+
+class UDialogueCharacter;
+
+DECLARE_DELEGATE_OneParam(FOnDialogueCharacterLoaded, UDialogueCharacter*);
+
+struct FDialogueCharacterCacheEntry
+{
+	TSharedPtr<FStreamableHandle> CharacterHandle;
+
+	TSharedPtr<FStreamableHandle> PortraitHandle;
+
+	/**Requests waiting for the character and its portrait.*/
+	TArray<FOnDialogueCharacterLoaded> PendingCallbacks;
+
+	/**Requests that haven't been released yet.
+	 * Entries that are in use are never evicted. */
+	int32 Users = 0;
+
+	/**Users that only prefetched the character for an upcoming node.*/
+	int32 PrefetchUsers = 0;
+
+	uint64 LastUsed = 0;
+
+	/**The character and its portrait are both resident.*/
+	bool Loaded = false;
+};
+
+/**
+ * Streams dialogue characters and their portraits in the background
+ * and keeps the most recently used ones resident, so a character that
+ * speaks again doesn't have to be loaded again.
+ *
+ * Every RequestCharacter has to be matched by a ReleaseCharacter.
+ * Released characters stay cached until the cache grows beyond
+ * Dialogue.CharacterCacheSize, least recently used first.
+ */
+UCLASS()
+class BT_DIALOGUE_API UDialogueAssetSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UDialogueAssetSubsystem* Get();
+
+	virtual void Deinitialize() override;
+
+	/**Stream in @Character and its portrait. @OnLoaded is called once both
+	 * are resident, right away if they already are. */
+	void RequestCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character, FOnDialogueCharacterLoaded OnLoaded = FOnDialogueCharacterLoaded(),
+		TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+	void ReleaseCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character);
+
+	/**Stream in a character for a dialogue node that might come up next,
+	 * at a low priority. Returns false without loading anything if the
+	 * prefetched portraits already exceed Dialogue.Prefetch.BudgetMB.
+	 * Every successful prefetch has to be matched by ReleasePrefetchedCharacter. */
+	bool PrefetchCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character);
+
+	void ReleasePrefetchedCharacter(const TSoftObjectPtr<UDialogueCharacter>& Character);
+
+	/**Stream in other assets an upcoming dialogue node needs, such as voice lines,
+	 * at a low priority and within the same budget as PrefetchCharacter.
+	 * Returns null without loading anything if the budget is spent.
+	 * Release the handle once the node no longer needs the assets. */
+	TSharedPtr<FStreamableHandle> PrefetchAssets(const TArray<FSoftObjectPath>& Assets);
+
+	/**Memory used by portraits and assets that are only loaded because they
+	 * were prefetched. Loads still in flight count with their size on disk. */
+	int64 GetPrefetchedBytes() const;
+
+	/**Never loads anything, returns null if the portrait isn't resident yet.*/
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	UTexture2D* GetLoadedPortrait(TSoftObjectPtr<UDialogueCharacter> Character) const;
+
+	UFUNCTION(Category = "Dialogue", BlueprintPure)
+	bool IsCharacterLoaded(TSoftObjectPtr<UDialogueCharacter> Character) const;
+
+	int32 GetCachedCharacterCount() const
+	{
+		return Entries.Num();
+	}
+
+private:
+
+	TMap<FSoftObjectPath, FDialogueCharacterCacheEntry> Entries;
+
+	uint64 UseCounter = 0;
+
+	/**Handles returned by PrefetchAssets, dropped once released.*/
+	TArray<TWeakPtr<FStreamableHandle>> AssetPrefetches;
+
+	bool IsPrefetchBudgetSpent() const;
+
+	void OnCharacterLoaded(FSoftObjectPath CharacterPath, TAsyncLoadPriority Priority);
+
+	void OnPortraitLoaded(FSoftObjectPath CharacterPath);
+
+	/**Evict released characters until the cache fits its size.*/
+	void TrimCache();
+
+	static void ReleaseEntry(FDialogueCharacterCacheEntry& Entry);
+};
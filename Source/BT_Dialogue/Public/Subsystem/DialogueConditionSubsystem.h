@@ -0,0 +1,56 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "DialogueConditionSubsystem.generated.h"
+
+/**An empty tag means anything might have changed.*/
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDialogueDependencyChanged, const FGameplayTag&);
+
+/**
+ * Tells active dialogue tasks when something their option conditions
+ * depend on has changed, so they only evaluate those conditions again.
+ *
+ * Conditions declare what they depend on through their DependencyTags.
+ * If TagFacts is installed, every fact change is forwarded with the
+ * fact's tag, which includes the quest and objective facts the quest
+ * system records. Any other state has to call NotifyDependencyChanged
+ * with the tag that changed.
+ */
+UCLASS()
+class BT_DIALOGUE_API UDialogueConditionSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UDialogueConditionSubsystem* Get();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**Re-evaluate every active dialogue condition that depends on @Tag,
+	 * or on a parent of it. */
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void NotifyDependencyChanged(FGameplayTag Tag);
+
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void NotifyDependenciesChanged(const FGameplayTagContainer& Tags);
+
+	/**Re-evaluate every active dialogue condition that has dependencies,
+	 * for example after loading a save game. */
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void NotifyAllDependenciesChanged();
+
+	FOnDialogueDependencyChanged OnDependencyChanged;
+
+private:
+
+	/**Bound to TagFacts when it's installed.*/
+	UFUNCTION()
+	void OnFactUpdated(FGameplayTag Fact, int32 NewValue);
+};
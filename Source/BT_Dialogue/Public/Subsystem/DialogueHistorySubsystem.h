@@ -0,0 +1,67 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DialogueHistorySubsystem.generated.h"
+
+/**Which remembered dialogue options have been chosen and how often.
+ * Store this in your save game. */
+USTRUCT(BlueprintType)
+struct FDialogueHistory
+{
+	GENERATED_BODY()
+
+	/**Times chosen, keyed by the CRC of the option's OptionFact.*/
+	UPROPERTY(SaveGame)
+	TMap<uint32, int32> TimesChosen;
+};
+
+/**
+ * Remembers the dialogue options the player has chosen, for options
+ * with RememberOptionSelection enabled. Works without TagFacts.
+ *
+ * Options are identified by their OptionFact. Only a hash of the tag
+ * and a counter are stored per option, and lookups are O(1).
+ */
+UCLASS()
+class BT_DIALOGUE_API UDialogueHistorySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UDialogueHistorySubsystem* Get(const UObject* WorldContext);
+
+	static uint32 GetOptionID(const FGameplayTag& OptionFact);
+
+	void RecordChoice(const FGameplayTag& OptionFact);
+
+	UFUNCTION(Category = "Dialogue|History", BlueprintPure)
+	bool HasChosen(FGameplayTag OptionFact) const
+	{
+		return TimesChosen(OptionFact) > 0;
+	}
+
+	UFUNCTION(Category = "Dialogue|History", BlueprintPure)
+	int32 TimesChosen(FGameplayTag OptionFact) const;
+
+	UFUNCTION(Category = "Dialogue|History", BlueprintCallable)
+	FDialogueHistory GetHistory() const
+	{
+		return History;
+	}
+
+	/**Replace the history, for example with the one from a loaded save game.*/
+	UFUNCTION(Category = "Dialogue|History", BlueprintCallable)
+	void SetHistory(const FDialogueHistory& NewHistory);
+
+	UFUNCTION(Category = "Dialogue|History", BlueprintCallable)
+	void ClearHistory();
+
+private:
+
+	FDialogueHistory History;
+};
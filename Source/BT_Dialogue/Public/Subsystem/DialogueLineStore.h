@@ -0,0 +1,81 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "DialogueLineStore.generated.h"
+
+/**A line of dialogue in a string table.*/
+USTRUCT(BlueprintType)
+struct FDialogueLineID
+{
+	GENERATED_BODY()
+
+	/**ID of the string table, usually the package path of the string table asset.*/
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadWrite)
+	FName TableID;
+
+	UPROPERTY(Category = "Dialogue", EditAnywhere, BlueprintReadWrite)
+	FName Key;
+
+	bool IsValid() const
+	{
+		return !TableID.IsNone() && !Key.IsNone();
+	}
+
+	bool operator==(const FDialogueLineID& Other) const
+	{
+		return TableID == Other.TableID && Key == Other.Key;
+	}
+
+	friend uint32 GetTypeHash(const FDialogueLineID& LineID)
+	{
+		return HashCombineFast(GetTypeHash(LineID.TableID), GetTypeHash(LineID.Key));
+	}
+};
+
+/**
+ * Resolves dialogue lines from string tables the first time they are
+ * shown, instead of every dialogue task carrying the text of its lines.
+ *
+ * Resolved lines are kept in a least recently used cache of
+ * Dialogue.LineCacheSize lines, so memory depends on how much dialogue
+ * is being shown rather than how many dialogue graphs are loaded.
+ * The cache is flushed when the culture changes.
+ */
+UCLASS()
+class BT_DIALOGUE_API UDialogueLineStore : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UDialogueLineStore();
+
+	static UDialogueLineStore* Get();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**Text of the line in the current culture. String tables that
+	 * aren't loaded yet are loaded, missing lines return empty text. */
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	FText ResolveLine(FDialogueLineID LineID);
+
+	UFUNCTION(Category = "Dialogue", BlueprintCallable)
+	void FlushCache();
+
+	int32 GetCachedLineCount() const
+	{
+		return ResolvedLines.Num();
+	}
+
+private:
+
+	TLruCache<FDialogueLineID, FText> ResolvedLines;
+
+	FDelegateHandle CultureChangedHandle;
+};
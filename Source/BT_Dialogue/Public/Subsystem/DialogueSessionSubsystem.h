@@ -0,0 +1,109 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DialogueSessionSubsystem.generated.h"
+
+class APlayerController;
+class UUserWidget;
+
+/**How many widgets the session has created and how many it reused.*/
+USTRUCT(BlueprintType)
+struct FDialogueSessionStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	int32 ScreensCreated = 0;
+
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	int32 OptionWidgetsCreated = 0;
+
+	/**Every AcquireOptionWidget call, whether it created a widget or not.*/
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	int32 OptionWidgetsAcquired = 0;
+
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	int32 OptionWidgetsInUse = 0;
+
+	UPROPERTY(Category = "Dialogue", BlueprintReadOnly)
+	int32 OptionWidgetsPooled = 0;
+};
+
+USTRUCT()
+struct FDialogueWidgetPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UUserWidget>> FreeWidgets;
+};
+
+/**
+ * Keeps one dialogue screen alive across consecutive dialogue tasks
+ * and pools the widgets used for option buttons, so a conversation
+ * doesn't create new widgets for every line.
+ *
+ * Dialogue tasks get their screen through UDialogueTask::GetDialogueScreen
+ * and their option buttons through UDialogueTask::AcquireOptionWidget,
+ * which hands them back to the pool when the task is deactivated.
+ */
+UCLASS()
+class BT_DIALOGUE_API UDialogueSessionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UDialogueSessionSubsystem* Get(const UObject* WorldContext);
+
+	virtual void Deinitialize() override;
+
+	/**Returns the session's screen, creating it if there is none or it
+	 * isn't a @ScreenClass, and adds it to the viewport if it isn't shown.
+	 * If @OwningPlayer is null, the first local player owns the screen. */
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable, meta = (DeterminesOutputType = "ScreenClass"))
+	UUserWidget* AcquireScreen(TSubclassOf<UUserWidget> ScreenClass, APlayerController* OwningPlayer = nullptr, int32 ZOrder = 0);
+
+	UFUNCTION(Category = "Dialogue|Session", BlueprintPure)
+	UUserWidget* GetScreen() const
+	{
+		return Screen;
+	}
+
+	/**Remove the screen from the viewport. It's kept,
+	 * so the next conversation can show it again. */
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable)
+	void ReleaseScreen();
+
+	/**Take a widget of @WidgetClass out of the pool, or create one if the pool is empty.*/
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable, meta = (DeterminesOutputType = "WidgetClass"))
+	UUserWidget* AcquireOptionWidget(TSubclassOf<UUserWidget> WidgetClass);
+
+	/**Remove @Widget from its parent and put it back in the pool.
+	 * Widgets beyond Dialogue.OptionWidgetPoolSize are left to be collected. */
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable)
+	void ReleaseOptionWidget(UUserWidget* Widget);
+
+	UFUNCTION(Category = "Dialogue|Session", BlueprintPure)
+	FDialogueSessionStats GetStats() const
+	{
+		return Stats;
+	}
+
+	/**Reset the created and acquired counters. Widgets in use and pooled are kept.*/
+	UFUNCTION(Category = "Dialogue|Session", BlueprintCallable)
+	void ResetStats();
+
+private:
+
+	UPROPERTY()
+	TObjectPtr<UUserWidget> Screen = nullptr;
+
+	UPROPERTY()
+	TMap<TSubclassOf<UUserWidget>, FDialogueWidgetPool> OptionWidgetPools;
+
+	FDialogueSessionStats Stats;
+};
@@ -22,6 +22,8 @@ public class BT_Quests : ModuleRules
             {
                 "CoreUObject",
                 "Engine",
+                "AssetRegistry",
+                "BlueprintTasksExtension",
                 "Slate",
                 "SlateCore"
             }
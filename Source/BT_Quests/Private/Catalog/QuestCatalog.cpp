@@ -0,0 +1,295 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Catalog/QuestCatalog.h"
+
+#include "BT_Quests.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "DataAssets/QuestAsset.h"
+#include "DataAssets/QuestChain.h"
+
+UQuestCatalog* UQuestCatalog::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UQuestCatalog>() : nullptr;
+}
+
+void UQuestCatalog::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if(AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject(this, &UQuestCatalog::BuildCatalog);
+	}
+	else
+	{
+		BuildCatalog();
+	}
+
+#if WITH_EDITOR
+	/**Quests can be created, deleted and edited while the editor is running.
+	 * Invalidate the catalog, it's rebuilt the next time it's used. */
+	AssetRegistry.OnAssetAdded().AddUObject(this, &UQuestCatalog::OnAssetChanged);
+	AssetRegistry.OnAssetRemoved().AddUObject(this, &UQuestCatalog::OnAssetChanged);
+	AssetRegistry.OnAssetUpdated().AddUObject(this, &UQuestCatalog::OnAssetChanged);
+	AssetRegistry.OnAssetRenamed().AddUObject(this, &UQuestCatalog::OnAssetRenamed);
+#endif
+}
+
+void UQuestCatalog::Deinitialize()
+{
+	if(FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnFilesLoaded().RemoveAll(this);
+#if WITH_EDITOR
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetUpdated().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+#endif
+	}
+
+	Super::Deinitialize();
+}
+
+const TArray<FQuestCatalogEntry>& UQuestCatalog::GetQuests()
+{
+	EnsureBuilt();
+	return Entries;
+}
+
+bool UQuestCatalog::FindQuestByID(FGameplayTag QuestID, FQuestCatalogEntry& OutEntry)
+{
+	EnsureBuilt();
+
+	if(const int32* Index = EntriesByID.Find(QuestID))
+	{
+		OutEntry = Entries[*Index];
+		return true;
+	}
+
+	return false;
+}
+
+bool UQuestCatalog::FindQuestByName(const FString& Name, FQuestCatalogEntry& OutEntry)
+{
+	EnsureBuilt();
+
+	if(const int32* Index = EntriesByName.Find(Name))
+	{
+		OutEntry = Entries[*Index];
+		return true;
+	}
+
+	return false;
+}
+
+TArray<FQuestCatalogEntry> UQuestCatalog::GetQuestsInChain(const FString& ChainName)
+{
+	EnsureBuilt();
+
+	TArray<FQuestCatalogEntry> ChainQuests;
+	if(const TArray<int32>* Indices = EntriesByChain.Find(ChainName))
+	{
+		ChainQuests.Reserve(Indices->Num());
+		for(const int32 Index : *Indices)
+		{
+			ChainQuests.Add(Entries[Index]);
+		}
+	}
+
+	return ChainQuests;
+}
+
+TArray<FQuestCatalogEntry> UQuestCatalog::SearchQuests(const FString& Query, int32 MaxResults)
+{
+	TArray<FQuestSearchResult> Results;
+	SearchQuestIndices(Query, MaxResults, Results);
+
+	TArray<FQuestCatalogEntry> MatchingQuests;
+	MatchingQuests.Reserve(Results.Num());
+	for(const FQuestSearchResult& Result : Results)
+	{
+		MatchingQuests.Add(Entries[Result.EntryIndex]);
+	}
+
+	return MatchingQuests;
+}
+
+void UQuestCatalog::SearchQuestIndices(const FString& Query, int32 MaxResults, TArray<FQuestSearchResult>& OutResults)
+{
+	EnsureBuilt();
+	SearchIndex.Search(Query, MaxResults, OutResults);
+}
+
+int32 UQuestCatalog::FindQuestIndex(const TSoftObjectPtr<UQuestAsset>& Quest)
+{
+	EnsureBuilt();
+
+	const int32* Index = EntriesByPath.Find(Quest.ToSoftObjectPath());
+	return Index ? *Index : INDEX_NONE;
+}
+
+void UQuestCatalog::BuildCatalog()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(BuildQuestCatalog)
+	const double StartTime = FPlatformTime::Seconds();
+
+	Entries.Reset();
+	EntriesByID.Reset();
+	EntriesByName.Reset();
+	EntriesByPath.Reset();
+	EntriesByChain.Reset();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	TArray<FAssetData> QuestAssets;
+	AssetRegistry.GetAssetsByClass(UQuestAsset::StaticClass()->GetClassPathName(), QuestAssets, true);
+
+	/**Reading the tags is the bulk of the work and every asset
+	 * is independent, so spread it across the task graph. */
+	TArray<FString> QuestIDs;
+	QuestIDs.SetNum(QuestAssets.Num());
+	Entries.SetNum(QuestAssets.Num());
+	ParallelFor(QuestAssets.Num(), [this, &QuestAssets, &QuestIDs](int32 Index)
+	{
+		const FAssetData& AssetData = QuestAssets[Index];
+		FQuestCatalogEntry& Entry = Entries[Index];
+
+		Entry.Quest = TSoftObjectPtr<UQuestAsset>(AssetData.GetSoftObjectPath());
+		Entry.AssetName = AssetData.AssetName;
+		AssetData.GetTagValue(BTE::QuestName_Tag, Entry.QuestName);
+		AssetData.GetTagValue(BTE::QuestID_Tag, QuestIDs[Index]);
+	});
+
+	//The maps and the gameplay tag manager aren't thread safe, fill them in serially.
+	EntriesByID.Reserve(Entries.Num());
+	EntriesByName.Reserve(Entries.Num() * 2);
+	EntriesByPath.Reserve(Entries.Num());
+	TMap<FName, int32> EntriesByPackage;
+	EntriesByPackage.Reserve(Entries.Num());
+
+	for(int32 Index = 0; Index < Entries.Num(); Index++)
+	{
+		FQuestCatalogEntry& Entry = Entries[Index];
+
+		Entry.QuestID = FGameplayTag::RequestGameplayTag(FName(QuestIDs[Index]), false);
+		if(Entry.QuestID.IsValid())
+		{
+			EntriesByID.Add(Entry.QuestID, Index);
+		}
+
+		EntriesByName.Add(Entry.AssetName.ToString(), Index);
+		if(!Entry.QuestName.IsEmpty())
+		{
+			//Asset names take priority if a player facing name collides with one
+			EntriesByName.FindOrAdd(Entry.QuestName, Index);
+		}
+
+		EntriesByPath.Add(Entry.Quest.ToSoftObjectPath(), Index);
+		EntriesByPackage.Add(QuestAssets[Index].PackageName, Index);
+	}
+
+	/**Chains list their quests in an asset registry tag, so chains
+	 * can be mapped to quests without loading either. */
+	TArray<FAssetData> ChainAssets;
+	AssetRegistry.GetAssetsByClass(UQuestChain::StaticClass()->GetClassPathName(), ChainAssets, true);
+
+	TArray<FString> QuestPaths;
+	TArray<FName> Dependencies;
+	for(const FAssetData& ChainAsset : ChainAssets)
+	{
+		FString ChainName;
+		if(!ChainAsset.GetTagValue(BTE::QuestChainName_Tag, ChainName) || ChainName.IsEmpty())
+		{
+			ChainName = ChainAsset.AssetName.ToString();
+		}
+
+		TArray<int32>& ChainEntries = EntriesByChain.FindOrAdd(ChainName);
+		auto AddChainEntry = [this, &ChainEntries, &ChainName](int32 Index)
+		{
+			ChainEntries.AddUnique(Index);
+			Entries[Index].ChainNames.AddUnique(ChainName);
+		};
+
+		FString QuestPathsTag;
+		if(ChainAsset.GetTagValue(BTE::QuestChainQuests_Tag, QuestPathsTag))
+		{
+			QuestPaths.Reset();
+			QuestPathsTag.ParseIntoArray(QuestPaths, BTE::QuestChainQuests_Delimiter);
+			for(const FString& QuestPath : QuestPaths)
+			{
+				if(const int32* Index = EntriesByPath.Find(FSoftObjectPath(QuestPath)))
+				{
+					AddChainEntry(*Index);
+				}
+			}
+			continue;
+		}
+
+		/**Chains that haven't been saved since the tag was added.
+		 * Their soft references are recorded as package dependencies,
+		 * which only the editor's asset registry keeps. */
+		Dependencies.Reset();
+		AssetRegistry.GetDependencies(ChainAsset.PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package);
+		for(const FName& Dependency : Dependencies)
+		{
+			if(const int32* Index = EntriesByPackage.Find(Dependency))
+			{
+				AddChainEntry(*Index);
+			}
+		}
+	}
+
+	SearchIndex.Build(Entries);
+
+	Built = true;
+	BuildCount++;
+
+	UE_LOG(LogQuestSystem, Log, TEXT("Built quest catalog with %i quests and %i chains in %.2fms"),
+		Entries.Num(), EntriesByChain.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UQuestCatalog::EnsureBuilt()
+{
+	if(Built)
+	{
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if(AssetRegistry.IsLoadingAssets())
+	{
+		UE_LOG(LogQuestSystem, Log, TEXT("Quest catalog was used before the asset registry finished scanning, waiting for it"));
+		AssetRegistry.WaitForCompletion();
+	}
+
+	BuildCatalog();
+}
+
+#if WITH_EDITOR
+void UQuestCatalog::OnAssetChanged(const FAssetData& AssetData)
+{
+	if(!Built)
+	{
+		return;
+	}
+
+	if(const UClass* AssetClass = AssetData.GetClass(EResolveClass::No))
+	{
+		if(AssetClass->IsChildOf(UQuestAsset::StaticClass()) || AssetClass->IsChildOf(UQuestChain::StaticClass()))
+		{
+			Built = false;
+		}
+	}
+}
+
+void UQuestCatalog::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	OnAssetChanged(AssetData);
+}
+#endif
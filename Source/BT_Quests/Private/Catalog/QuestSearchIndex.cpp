@@ -0,0 +1,175 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Catalog/QuestSearchIndex.h"
+
+#include "Algo/BinarySearch.h"
+#include "Catalog/QuestCatalog.h"
+
+namespace
+{
+	/**Fuzzy matches need at least this fraction of the
+	 * query's trigrams to be considered a candidate.*/
+	constexpr float MinTrigramOverlap = 0.5f;
+}
+
+void FQuestSearchIndex::Build(const TArray<FQuestCatalogEntry>& Entries)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(BuildQuestSearchIndex)
+
+	Reset();
+	Keys.Reserve(Entries.Num() * 3);
+
+	for(int32 Index = 0; Index < Entries.Num(); Index++)
+	{
+		const FQuestCatalogEntry& Entry = Entries[Index];
+
+		Keys.Add({Entry.AssetName.ToString().ToLower(), Index});
+		if(!Entry.QuestName.IsEmpty())
+		{
+			Keys.Add({Entry.QuestName.ToLower(), Index});
+		}
+		if(Entry.QuestID.IsValid())
+		{
+			Keys.Add({Entry.QuestID.ToString().ToLower(), Index});
+		}
+	}
+
+	Keys.Sort([](const FKey& A, const FKey& B)
+	{
+		return A.Text.Compare(B.Text, ESearchCase::CaseSensitive) < 0;
+	});
+
+	//Keys are visited in order, so every posting list ends up sorted.
+	TArray<uint64> KeyTrigrams;
+	for(int32 KeyIndex = 0; KeyIndex < Keys.Num(); KeyIndex++)
+	{
+		GatherTrigrams(Keys[KeyIndex].Text, KeyTrigrams);
+		for(const uint64 Trigram : KeyTrigrams)
+		{
+			Trigrams.FindOrAdd(Trigram).Add(KeyIndex);
+		}
+	}
+}
+
+void FQuestSearchIndex::Search(const FString& Query, int32 MaxResults, TArray<FQuestSearchResult>& OutResults) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(QuestSearchIndex_Search)
+
+	OutResults.Reset();
+
+	const FString LowerQuery = Query.TrimStartAndEnd().ToLower();
+	if(LowerQuery.IsEmpty() || MaxResults <= 0)
+	{
+		return;
+	}
+
+	//Key index to the amount of trigrams it shares with the query
+	TMap<int32, int32> Candidates;
+
+	const int32 FirstPrefix = Algo::LowerBound(Keys, LowerQuery, [](const FKey& Key, const FString& Value)
+	{
+		return Key.Text.Compare(Value, ESearchCase::CaseSensitive) < 0;
+	});
+	for(int32 KeyIndex = FirstPrefix; KeyIndex < Keys.Num(); KeyIndex++)
+	{
+		if(!Keys[KeyIndex].Text.StartsWith(LowerQuery, ESearchCase::CaseSensitive))
+		{
+			break;
+		}
+		Candidates.Add(KeyIndex, 0);
+	}
+
+	TArray<uint64> QueryTrigrams;
+	GatherTrigrams(LowerQuery, QueryTrigrams);
+	for(const uint64 Trigram : QueryTrigrams)
+	{
+		if(const TArray<int32>* Postings = Trigrams.Find(Trigram))
+		{
+			for(const int32 KeyIndex : *Postings)
+			{
+				Candidates.FindOrAdd(KeyIndex)++;
+			}
+		}
+	}
+
+	//An entry has up to three keys, only its best one counts
+	TMap<int32, float> EntryScores;
+	for(const TPair<int32, int32>& Candidate : Candidates)
+	{
+		const FKey& Key = Keys[Candidate.Key];
+		const float Score = ScoreKey(Key.Text, LowerQuery, Candidate.Value, QueryTrigrams.Num());
+		if(Score <= 0)
+		{
+			continue;
+		}
+
+		float& EntryScore = EntryScores.FindOrAdd(Key.EntryIndex);
+		EntryScore = FMath::Max(EntryScore, Score);
+	}
+
+	OutResults.Reserve(EntryScores.Num());
+	for(const TPair<int32, float>& EntryScore : EntryScores)
+	{
+		OutResults.Add({EntryScore.Key, EntryScore.Value});
+	}
+
+	OutResults.Sort([](const FQuestSearchResult& A, const FQuestSearchResult& B)
+	{
+		//Tie break on the catalog order, so results are stable between calls
+		return A.Score != B.Score ? A.Score > B.Score : A.EntryIndex < B.EntryIndex;
+	});
+
+	if(OutResults.Num() > MaxResults)
+	{
+		OutResults.SetNum(MaxResults);
+	}
+}
+
+void FQuestSearchIndex::Reset()
+{
+	Keys.Reset();
+	Trigrams.Reset();
+}
+
+void FQuestSearchIndex::GatherTrigrams(const FString& Text, TArray<uint64>& OutTrigrams)
+{
+	OutTrigrams.Reset();
+
+	for(int32 Index = 0; Index + 2 < Text.Len(); Index++)
+	{
+		const uint64 Trigram =
+			(static_cast<uint64>(Text[Index]) << 42)
+			| (static_cast<uint64>(Text[Index + 1]) << 21)
+			| static_cast<uint64>(Text[Index + 2]);
+		OutTrigrams.AddUnique(Trigram);
+	}
+}
+
+float FQuestSearchIndex::ScoreKey(const FString& Key, const FString& Query, int32 SharedTrigrams, int32 QueryTrigrams)
+{
+	const float LengthRatio = static_cast<float>(Query.Len()) / FMath::Max(Key.Len(), 1);
+
+	if(Key.Equals(Query, ESearchCase::CaseSensitive))
+	{
+		return 3;
+	}
+
+	if(Key.StartsWith(Query, ESearchCase::CaseSensitive))
+	{
+		return 2 + LengthRatio;
+	}
+
+	if(Key.Contains(Query, ESearchCase::CaseSensitive))
+	{
+		return 1 + LengthRatio;
+	}
+
+	if(QueryTrigrams == 0)
+	{
+		return 0;
+	}
+
+	const float Overlap = static_cast<float>(SharedTrigrams) / QueryTrigrams;
+	return Overlap >= MinTrigramOverlap ? Overlap : 0;
+}
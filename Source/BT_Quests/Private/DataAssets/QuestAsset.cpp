@@ -5,6 +5,112 @@
 
 #include "UObject/AssetRegistryTagsContext.h"
 
+#if WITH_EDITOR
+#include "Misc/DataValidation.h"
+#endif
+
+void FQuestObjectiveGraph::Build(const TArray<FQuestObjectiveStage>& Stages)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(BuildQuestObjectiveGraph)
+	
+	ObjectiveIndices.Reset();
+	Locations.Reset();
+	Dependents.Reset();
+	InDegrees.Reset();
+	TopologicalOrder.Reset();
+	HasCycle = false;
+
+	for(int32 StageIndex = 0; StageIndex < Stages.Num(); StageIndex++)
+	{
+		for(int32 ObjectiveIndex = 0; ObjectiveIndex < Stages[StageIndex].Objectives.Num(); ObjectiveIndex++)
+		{
+			ObjectiveIndices.Add(Stages[StageIndex].Objectives[ObjectiveIndex].ObjectiveID, Locations.Num());
+			Locations.Add({ StageIndex, ObjectiveIndex });
+		}
+	}
+
+	Dependents.SetNum(Locations.Num());
+	InDegrees.SetNumZeroed(Locations.Num());
+
+	for(int32 FlatIndex = 0; FlatIndex < Locations.Num(); FlatIndex++)
+	{
+		const FQuestObjectiveLocation& Location = Locations[FlatIndex];
+		const FQuestObjective& Objective = Stages[Location.Stage].Objectives[Location.Objective];
+		
+		for(const FGameplayTag& Dependency : Objective.ObjectiveDependencies)
+		{
+			const int32 DependencyIndex = FindObjective(Dependency);
+			if(DependencyIndex == INDEX_NONE || DependencyIndex == FlatIndex)
+			{
+				continue;
+			}
+
+			/**Earlier stages are always completed before this stage starts,
+			 * while later stages are invalid and reported during validation. */
+			if(Locations[DependencyIndex].Stage != Location.Stage)
+			{
+				continue;
+			}
+
+			Dependents[DependencyIndex].Add(FlatIndex);
+			InDegrees[FlatIndex]++;
+		}
+	}
+
+	/**Kahn's algorithm, stage by stage so the order also respects the stages.*/
+	TArray<int32> PendingDegrees = InDegrees;
+	TArray<int32> Queue;
+	Queue.Reserve(Locations.Num());
+	
+	int32 StageStart = 0;
+	while(StageStart < Locations.Num())
+	{
+		const int32 Stage = Locations[StageStart].Stage;
+		int32 StageEnd = StageStart;
+		while(StageEnd < Locations.Num() && Locations[StageEnd].Stage == Stage)
+		{
+			if(PendingDegrees[StageEnd] == 0)
+			{
+				Queue.Add(StageEnd);
+			}
+			StageEnd++;
+		}
+
+		for(int32 QueueIndex = 0; QueueIndex < Queue.Num(); QueueIndex++)
+		{
+			const int32 Current = Queue[QueueIndex];
+			TopologicalOrder.Add(Current);
+			
+			for(const int32 Dependent : Dependents[Current])
+			{
+				if(--PendingDegrees[Dependent] == 0)
+				{
+					Queue.Add(Dependent);
+				}
+			}
+		}
+
+		if(Queue.Num() != StageEnd - StageStart)
+		{
+			HasCycle = true;
+		}
+
+		Queue.Reset();
+		StageStart = StageEnd;
+	}
+}
+
+const FQuestObjectiveGraph& UQuestAsset::GetObjectiveGraph() const
+{
+	if(!ObjectiveGraphBuilt)
+	{
+		ObjectiveGraph.Build(ObjectiveStages);
+		ObjectiveGraphBuilt = true;
+	}
+
+	return ObjectiveGraph;
+}
+
 FPrimaryAssetId UQuestAsset::GetPrimaryAssetId() const
 {
 	return FPrimaryAssetId(FName("Quest Asset"), GetFName());
@@ -17,3 +123,62 @@ void UQuestAsset::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
 	
 	Super::GetAssetRegistryTags(Context);
 }
+
+void UQuestAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	//Build the graph now rather than when the quest is accepted
+	GetObjectiveGraph();
+}
+
+#if WITH_EDITOR
+EDataValidationResult UQuestAsset::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = CombineDataValidationResults(Super::IsDataValid(Context), EDataValidationResult::Valid);
+
+	const FQuestObjectiveGraph& Graph = GetObjectiveGraph();
+	for(int32 FlatIndex = 0; FlatIndex < Graph.Locations.Num(); FlatIndex++)
+	{
+		const FQuestObjectiveLocation& Location = Graph.Locations[FlatIndex];
+		const FQuestObjective& Objective = ObjectiveStages[Location.Stage].Objectives[Location.Objective];
+
+		for(const FGameplayTag& Dependency : Objective.ObjectiveDependencies)
+		{
+			const int32 DependencyIndex = Graph.FindObjective(Dependency);
+			if(DependencyIndex == INDEX_NONE)
+			{
+				Result = EDataValidationResult::Invalid;
+				Context.AddError(FText::FromString(FString::Printf(TEXT("Objective %s depends on %s, which is not part of this quest"),
+					*Objective.ObjectiveID.ToString(), *Dependency.ToString())));
+			}
+			else if(DependencyIndex == FlatIndex)
+			{
+				Result = EDataValidationResult::Invalid;
+				Context.AddError(FText::FromString(FString::Printf(TEXT("Objective %s depends on itself"), *Objective.ObjectiveID.ToString())));
+			}
+			else if(Graph.Locations[DependencyIndex].Stage > Location.Stage)
+			{
+				Result = EDataValidationResult::Invalid;
+				Context.AddError(FText::FromString(FString::Printf(TEXT("Objective %s depends on %s, which is in a later stage"),
+					*Objective.ObjectiveID.ToString(), *Dependency.ToString())));
+			}
+		}
+	}
+
+	if(Graph.HasCycle)
+	{
+		Result = EDataValidationResult::Invalid;
+		Context.AddError(FText::FromString("Objective dependencies contain a cycle"));
+	}
+	
+	return Result;
+}
+
+void UQuestAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	ObjectiveGraphBuilt = false;
+}
+#endif
@@ -12,6 +12,27 @@
 void UQuestChain::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
 {
 	Context.AddTag(FAssetRegistryTag(BTE::QuestChainName_Tag, ChainName.ToString(), FAssetRegistryTag::TT_Alphabetical));
+
+	/**Cooked asset registries don't keep package dependencies,
+	 * so the quests are listed in a tag for the quest catalog. */
+	TStringBuilder<512> QuestPaths;
+	for(const FBTQuestChainStage& CurrentStage : Stages)
+	{
+		for(const TSoftObjectPtr<UQuestAsset>& CurrentQuest : CurrentStage.Quests)
+		{
+			if(CurrentQuest.IsNull())
+			{
+				continue;
+			}
+
+			if(QuestPaths.Len() > 0)
+			{
+				QuestPaths << BTE::QuestChainQuests_Delimiter;
+			}
+			QuestPaths << CurrentQuest.ToSoftObjectPath().ToString();
+		}
+	}
+	Context.AddTag(FAssetRegistryTag(BTE::QuestChainQuests_Tag, QuestPaths.ToString(), FAssetRegistryTag::TT_Hidden));
 	
 	Super::GetAssetRegistryTags(Context);
 }
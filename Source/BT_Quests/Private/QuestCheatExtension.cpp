@@ -5,7 +5,7 @@
 
 #include "BT_Quests.h"
 #include "QuestSystem.h"
-#include "AssetRegistry/AssetRegistryModule.h"
+#include "Catalog/QuestCatalog.h"
 #include "Engine/AssetManager.h"
 
 UQuestCheatExtension::UQuestCheatExtension()
@@ -24,67 +24,66 @@ UQuestCheatExtension::UQuestCheatExtension()
 
 void UQuestCheatExtension::SetQuestState(const FString& PartialQuestName, const FString& NewState)
 {
-	if(NewState != "Inactive"
-		|| NewState != "InProgress"
-		|| NewState != "Completed"
-		|| NewState != "Failed"
-		|| NewState != "Locked")
+	const int64 StateValue = StaticEnum<EBTQuestState>()->GetValueByNameString(NewState);
+	if(StateValue == INDEX_NONE)
 	{
+		UE_LOG(LogQuestSystem, Warning, TEXT("'%s' is not a valid quest state"), *NewState);
 		return;
 	}
+	const EBTQuestState TargetState = static_cast<EBTQuestState>(StateValue);
 
-	TArray<FAssetData> AssetDataList;
-	FARFilter Filter;
-	Filter.ClassPaths.Add(UQuestAsset::StaticClass()->GetClassPathName());
-	
-	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
-	AssetRegistry.GetAssets(Filter, AssetDataList);
+	UQuestCatalog* QuestCatalog = UQuestCatalog::Get();
+	if(!QuestCatalog)
+	{
+		return;
+	}
+
+	TArray<FQuestSearchResult> Results;
+	QuestCatalog->SearchQuestIndices(PartialQuestName, 5, Results);
+	if(Results.IsEmpty())
+	{
+		UE_LOG(LogQuestSystem, Warning, TEXT("No asset matching '%s' was found!"), *PartialQuestName);
+		return;
+	}
 
-	FAssetData MatchingAssetData;
-	for(const FAssetData& AssetData : AssetDataList)
+	const TArray<FQuestCatalogEntry>& CatalogQuests = QuestCatalog->GetQuests();
+	const FQuestCatalogEntry& MatchingEntry = CatalogQuests[Results[0].EntryIndex];
+
+	if(Results.Num() > 1)
 	{
-		//Check if asset name contains the partial string (case-sensitive or insensitive as needed)
-		if (AssetData.AssetName.ToString().Contains(PartialQuestName))
+		//Let the user know what else matched, in case the best match wasn't what they meant
+		for(int32 Index = 1; Index < Results.Num(); Index++)
 		{
-			//Found the asset
-			MatchingAssetData = AssetData;
-			break;
+			UE_LOG(LogQuestSystem, Log, TEXT("SetQuestState: '%s' also matched %s"),
+				*PartialQuestName, *CatalogQuests[Results[Index].EntryIndex].AssetName.ToString());
 		}
 	}
 
-	if(MatchingAssetData.IsValid())
-	{
-		//Convert to soft object path
-		FSoftObjectPath AssetPath = MatchingAssetData.ToSoftObjectPath();
+	const FSoftObjectPath AssetPath = MatchingEntry.Quest.ToSoftObjectPath();
 
-		// If this asset is a primary asset (i.e. its class overrides GetPrimaryAssetId),
-		// you can now load it via the Asset Manager:
-		UAssetManager& Manager = UAssetManager::Get();
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPath,
+		FStreamableDelegate::CreateLambda([AssetPath, TargetState]()
+		{
+			UQuestAsset* QuestAsset = Cast<UQuestAsset>(AssetPath.ResolveObject());
 
-		// Here you could create a delegate for async loading; for example:
-		TArray<FName> Bundles;
-		Manager.LoadPrimaryAsset(MatchingAssetData.GetPrimaryAssetId(), Bundles,
-			FStreamableDelegate::CreateLambda([AssetPath, NewState]()
+			UQuestSystem* QuestSubSystem = UQuestSystem::Get();
+			if(!QuestSubSystem || !QuestAsset)
 			{
-				// Once loaded, get the asset object
-				// UObject* LoadedAsset = AssetPath.ResolveObject();
-				UQuestAsset* QuestAsset = Cast<UQuestAsset>(AssetPath.ResolveObject());
+				return;
+			}
 
-				UQuestSystem* QuestSubSystem = UQuestSystem::Get();
-				if(!QuestSubSystem)
-				{
-					return;
-				}
-
-				EBTQuestState QuestState = QuestSubSystem->GetQuestState(QuestAsset);
-				if(NewState == "Inactive")
+			EBTQuestState QuestState = QuestSubSystem->GetQuestState(QuestAsset);
+			switch(TargetState)
+			{
+			case EBTQuestState::Inactive:
 				{
 					if(QuestState != EBTQuestState::Inactive)
 					{
 						QuestSubSystem->AbandonQuest(QuestAsset);
 					}
+					break;
 				}
-				else if (NewState == "InProgress")
+			case EBTQuestState::InProgress:
 				{
 					if(QuestState == EBTQuestState::Completed || QuestState == EBTQuestState::Failed)
 					{
@@ -95,15 +94,17 @@ void UQuestCheatExtension::SetQuestState(const FString& PartialQuestName, const
 					{
 						QuestSubSystem->AcceptQuest(QuestAsset, true);
 					}
+					break;
 				}
-				else if (NewState == "Completed")
+			case EBTQuestState::Completed:
 				{
 					if(QuestState != EBTQuestState::Completed)
 					{
 						QuestSubSystem->CompleteQuest(QuestAsset, true, true);
 					}
+					break;
 				}
-				else if(NewState == "Failed")
+			case EBTQuestState::Failed:
 				{
 					if(QuestState == EBTQuestState::Inactive)
 					{
@@ -113,18 +114,14 @@ void UQuestCheatExtension::SetQuestState(const FString& PartialQuestName, const
 					{
 						QuestSubSystem->FailQuest(QuestAsset, true);
 					}
+					break;
 				}
-				else
+			default:
 				{
-					UE_LOG(LogQuestSystem, Log, TEXT("Invalid state passed into SetQuestState"))
+					UE_LOG(LogQuestSystem, Log, TEXT("Quests can't be forced into the %s state"),
+						*StaticEnum<EBTQuestState>()->GetNameStringByValue(static_cast<int64>(TargetState)))
+					break;
 				}
-			}));
-    
-		// Alternatively, you can use the Streamable Manager directly:
-		// UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPath, FStreamableDelegate::CreateLambda([...]));
-	}
-	else
-	{
-		UE_LOG(LogQuestSystem, Warning, TEXT("No asset matching '%s' was found!"), *PartialQuestName);
-	}
+			}
+		}));
 }
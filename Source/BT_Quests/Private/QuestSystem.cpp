@@ -10,6 +10,7 @@
 #include "BT_Quests.h"
 #include "DataAssets/QuestChain.h"
 #include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
 #include "Engine/StreamableManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Objects/QuestRequirementBase.h"
@@ -18,6 +19,33 @@
 #include "Core/FactSubSystem.h"
 #endif
 
+namespace
+{
+	/**Label the stage as active and put its objectives in progress,
+	 * or locked if they are still waiting on dependencies. */
+	void SetStageInProgress(FBTQuestWrapper& Quest, int32 StageIndex)
+	{
+		FQuestObjectiveStage& Stage = Quest.ObjectiveStages[StageIndex];
+		Stage.IsActive = true;
+
+		const FQuestObjectiveGraph& ObjectiveGraph = Quest.QuestAsset.LoadSynchronous()->GetObjectiveGraph();
+		for(auto& CurrentObjective : Stage.Objectives)
+		{
+			CurrentObjective.RootQuest = Quest.QuestAsset;
+			if(CurrentObjective.State != EBTQuestState::Inactive)
+			{
+				continue;
+			}
+			
+			const int32 FlatIndex = ObjectiveGraph.FindObjective(CurrentObjective.ObjectiveID);
+			const bool HasDependencies = Quest.RemainingDependencies.IsValidIndex(FlatIndex) && Quest.RemainingDependencies[FlatIndex] > 0;
+			CurrentObjective.State = HasDependencies ? EBTQuestState::Locked : EBTQuestState::InProgress;
+		}
+
+		Stage.RemainingRequired = Stage.CountUnresolvedRequired();
+	}
+}
+
 UQuestSystem::UQuestSystem()
 {
 }
@@ -28,6 +56,47 @@ UQuestSystem* UQuestSystem::Get()
 	return GEngine->GameViewport->GetWorld()->GetGameInstance()->GetSubsystem<UQuestSystem>();
 }
 
+void UQuestSystem::Deinitialize()
+{
+	ObjectiveTimerWheel.Reset();
+	ObjectiveTimers.Empty();
+	
+	Super::Deinitialize();
+}
+
+void UQuestSystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(QuestSystemTick)
+
+	ExpiredObjectiveTimers.Reset();
+	ObjectiveTimerWheel.Advance(DeltaTime, ExpiredObjectiveTimers);
+
+	for(const FGameplayTag& ObjectiveID : ExpiredObjectiveTimers)
+	{
+		OnObjectiveTimerExpired(ObjectiveID);
+	}
+}
+
+bool UQuestSystem::IsTickable() const
+{
+	return !ObjectiveTimerWheel.IsEmpty();
+}
+
+ETickableTickType UQuestSystem::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UQuestSystem::GetTickableGameObjectWorld() const
+{
+	return GetGameInstance() ? GetGameInstance()->GetWorld() : nullptr;
+}
+
+TStatId UQuestSystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UQuestSystem, STATGROUP_Tickables);
+}
+
 bool UQuestSystem::AcceptQuest(TSoftObjectPtr<UQuestAsset> Quest, bool ForceAccept)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(AcceptQuest)
@@ -55,6 +124,11 @@ bool UQuestSystem::AcceptQuest(TSoftObjectPtr<UQuestAsset> Quest, bool ForceAcce
 	FBTQuestWrapper QuestWrapper = CreateQuestWrapper(Quest);
 
 	QuestSubSystem->Quests.Add(Quest, QuestWrapper);
+	QuestSubSystem->RegisterObjectiveOwners(QuestWrapper);
+	if(QuestWrapper.ObjectiveStages.IsValidIndex(0))
+	{
+		QuestSubSystem->StartObjectiveTimers(QuestWrapper.ObjectiveStages[0]);
+	}
 	for(auto& CurrentChain : Quest->QuestChains)
 	{
 		if(!QuestSubSystem->QuestChains.Contains(CurrentChain))
@@ -156,6 +230,7 @@ void UQuestSystem::CompleteQuest(TSoftObjectPtr<UQuestAsset> Quest, bool SkipCom
 	}
 
 	QuestWrapper->State = EBTQuestState::Completed;
+	QuestSubSystem->ClearQuestTimers(*QuestWrapper);
 
 	//Safety check, mostly happens when a quest is force completed through a dev tool.
 	for(auto& CurrentQuest : GetRequiredQuestsForQuest(Quest))
@@ -167,23 +242,43 @@ void UQuestSystem::CompleteQuest(TSoftObjectPtr<UQuestAsset> Quest, bool SkipCom
 	}
 
 	/**If we are forcing this quest completion through the editor/dev tools,
-	 * then we need to forcibly complete non-optional objectives as well.*/
-	for(auto& CurrentStage : QuestWrapper->ObjectiveStages)
+	 * then we need to forcibly complete non-optional objectives as well.
+	 * Walk them in dependency order, so completing an objective unlocks
+	 * the ones waiting on it before we get to them.*/
+	const FQuestObjectiveGraph& ObjectiveGraph = Quest.LoadSynchronous()->GetObjectiveGraph();
+	for(const int32 FlatIndex : ObjectiveGraph.TopologicalOrder)
 	{
-		for(auto& CurrentObjective : CurrentStage.Objectives)
+		/**Completing required quests or objectives runs listeners,
+		 * which might have accepted quests and reallocated the map. */
+		QuestWrapper = QuestSubSystem->Quests.Find(Quest);
+		if(!QuestWrapper)
 		{
-			if(!CurrentObjective.IsOptional && CurrentObjective.State == EBTQuestState::InProgress)
-			{
-				CompleteObjective(CurrentObjective.ObjectiveID, nullptr);
-			}
-			// else
-			// {
-			// 	FailObjective(CurrentObjective.ObjectiveID, false);
-			// }
+			return;
+		}
+
+		const FQuestObjectiveLocation& Location = ObjectiveGraph.Locations[FlatIndex];
+		if(!QuestWrapper->ObjectiveStages.IsValidIndex(Location.Stage)
+			|| !QuestWrapper->ObjectiveStages[Location.Stage].Objectives.IsValidIndex(Location.Objective))
+		{
+			continue;
+		}
+		
+		const FQuestObjective& CurrentObjective = QuestWrapper->ObjectiveStages[Location.Stage].Objectives[Location.Objective];
+		if(!CurrentObjective.IsOptional && CurrentObjective.State == EBTQuestState::InProgress)
+		{
+			CompleteObjective(CurrentObjective.ObjectiveID, nullptr);
 		}
 	}
 	
-	QuestSubSystem->QuestCompleted.Broadcast(*QuestWrapper);
+	QuestWrapper = QuestSubSystem->Quests.Find(Quest);
+	if(!QuestWrapper)
+	{
+		return;
+	}
+
+	//Copied, listeners might reallocate the map
+	const FBTQuestWrapper CompletedQuest = *QuestWrapper;
+	QuestSubSystem->QuestCompleted.Broadcast(CompletedQuest);
 
 	#if TAGFACTS_INSTALLED
 	/**If TagFacts is installed, we increment a fact by one.
@@ -197,7 +292,7 @@ void UQuestSystem::CompleteQuest(TSoftObjectPtr<UQuestAsset> Quest, bool SkipCom
 	{
 		Sys->QueueMessageForBroadcast(
 			FAsyncMessageId(Quest.Get()->QuestID), 
-			FInstancedStruct::Make(*QuestWrapper));
+			FInstancedStruct::Make(CompletedQuest));
 	}
 	#endif
 		
@@ -241,6 +336,20 @@ bool UQuestSystem::CanCompleteQuest(FBTQuestWrapper Quest)
 		return false;
 	}
 
+	/**The counters can tell us in O(1) whether the last stage is done.
+	 * Quests from saves that predate them are scanned instead.*/
+	const FQuestObjectiveStage& LastStage = Quest.ObjectiveStages.Last();
+	if(LastStage.RemainingRequired != INDEX_NONE)
+	{
+		if(Quest.CurrentStage != Quest.ObjectiveStages.Num() - 1 || LastStage.RemainingRequired > 0)
+		{
+			UE_LOG(LogQuestSystem, Log, TEXT("Tried to complete quest %s, but an objective is still in progress."), *Quest.QuestAsset.GetAssetName());
+			return false;
+		}
+
+		return true;
+	}
+
 	for(auto& CurrentStage : Quest.ObjectiveStages)
 	{
 		if(!CurrentStage.IsComplete())
@@ -289,6 +398,8 @@ bool UQuestSystem::AbandonQuest(TSoftObjectPtr<UQuestAsset> Quest)
 
 	QuestSubSystem->QuestAbandoned.Broadcast(*QuestWrapper);
 
+	QuestSubSystem->ClearQuestTimers(*QuestWrapper);
+	QuestSubSystem->UnregisterObjectiveOwners(*QuestWrapper);
 	QuestSubSystem->Quests.Remove(Quest);
 
 	#if ENABLE_VISUAL_LOG
@@ -325,6 +436,7 @@ bool UQuestSystem::FailQuest(TSoftObjectPtr<UQuestAsset> Quest, bool FailObjecti
 	}
 
 	QuestWrapper->State = EBTQuestState::Failed;
+	QuestSubSystem->ClearQuestTimers(*QuestWrapper);
 
 	#if ENABLE_VISUAL_LOG
 	{
@@ -489,18 +601,11 @@ FBTQuestWrapper UQuestSystem::GetQuestForObjective(FGameplayTag Objective)
 		return FBTQuestWrapper();
 	}
 
-	for(auto& CurrentQuest : QuestSubSystem->Quests)
+	FBTQuestWrapper* QuestWrapper = nullptr;
+	int32 StageIndex = INDEX_NONE;
+	if(QuestSubSystem->FindObjective(Objective, QuestWrapper, StageIndex))
 	{
-		for(auto& CurrentStage : CurrentQuest.Value.ObjectiveStages)
-		{
-			for(auto& CurrentObjective : CurrentStage.Objectives)
-			{
-				if(CurrentObjective.ObjectiveID == Objective)
-				{
-					return CurrentQuest.Value;
-				}
-			}
-		}
+		return *QuestWrapper;
 	}
 	
 	return FBTQuestWrapper();
@@ -516,21 +621,11 @@ FQuestObjective UQuestSystem::GetObjectiveByID(FGameplayTag ObjectiveID)
 		return FQuestObjective();
 	}
 
-	FBTQuestWrapper FoundQuest = QuestSubSystem->GetQuestForObjective(ObjectiveID);
-	if(!FoundQuest.QuestAsset)
-	{
-		return FQuestObjective();
-	}
-
-	for(auto& CurrentStage : FoundQuest.ObjectiveStages)
+	FBTQuestWrapper* QuestWrapper = nullptr;
+	int32 StageIndex = INDEX_NONE;
+	if(const FQuestObjective* Objective = QuestSubSystem->FindObjective(ObjectiveID, QuestWrapper, StageIndex))
 	{
-		for(auto& CurrentObjective : CurrentStage.Objectives)
-		{
-			if(CurrentObjective.ObjectiveID == ObjectiveID)
-			{
-				return CurrentObjective;
-			}
-		}
+		return *Objective;
 	}
 
 	return FQuestObjective();
@@ -558,17 +653,13 @@ bool UQuestSystem::CompleteObjective(FGameplayTag ObjectiveID, UObject* Instigat
 	{
 		return false;
 	}
-	
-	FBTQuestWrapper FoundQuest = QuestSubSystem->GetQuestForObjective(ObjectiveID);
-	if(!FoundQuest.QuestAsset)
-	{
-		return false;
-	}
 
-	FQuestObjective Objective = GetObjectiveByID(ObjectiveID);
-	if(Objective.State == EBTQuestState::InProgress)
+	FBTQuestWrapper* QuestWrapper = nullptr;
+	int32 StageIndex = INDEX_NONE;
+	const FQuestObjective* Objective = QuestSubSystem->FindObjective(ObjectiveID, QuestWrapper, StageIndex);
+	if(Objective && Objective->State == EBTQuestState::InProgress)
 	{
-		ProgressObjective(ObjectiveID, Objective.ProgressRequired - Objective.CurrentProgress, Instigator);
+		ProgressObjective(ObjectiveID, Objective->ProgressRequired - Objective->CurrentProgress, Instigator);
 		return true;
 	}
 	
@@ -585,161 +676,86 @@ bool UQuestSystem::ProgressObjective(const FGameplayTag ObjectiveID, float Progr
 		return false;
 	}
 
-	FBTQuestWrapper Quest = QuestSubSystem->GetQuestForObjective(ObjectiveID);
-
-	FBTQuestWrapper* QuestWrapper = QuestSubSystem->Quests.Find(Quest.QuestAsset);
-	if(!QuestWrapper)
+	/**Only the objective with a matching ID is touched. Whether that completes
+	 * the stage or the quest is derived from the stages counter, so nothing
+	 * else has to be scanned. */
+	FBTQuestWrapper* QuestWrapper = nullptr;
+	int32 StageIndex = INDEX_NONE;
+	FQuestObjective* CurrentObjective = QuestSubSystem->FindObjective(ObjectiveID, QuestWrapper, StageIndex);
+	if(!CurrentObjective || !CanObjectiveBeProgressed(*CurrentObjective))
 	{
 		return false;
 	}
 
 	bool ObjectiveCompleted = false;
-	bool QuestCompleted = true;
-	bool ObjectiveProgressed = false;
+	bool QuestFinished = false;
+	TArray<FQuestObjective> UnlockedObjectives;
+	TArray<FQuestStageTransition> StageTransitions;
+	
+	const float ProgressDelta = (FMath::Clamp(CurrentObjective->CurrentProgress + ProgressToAdd, 0, CurrentObjective->ProgressRequired) - CurrentObjective->CurrentProgress);
+
+	CurrentObjective->CurrentProgress = FMath::Clamp(CurrentObjective->CurrentProgress + ProgressToAdd,0, CurrentObjective->ProgressRequired);
 
-	/**Find the stage that the objective resides in. Then progress the objective.
-	 * This will also check if all stages are now labelled complete, and if so,
-	 * complete the quest. */
-	for(int32 i = 0; i < QuestWrapper->ObjectiveStages.Num(); i++)
+	if(CurrentObjective->CurrentProgress == CurrentObjective->ProgressRequired)
 	{
-		if(i == QuestWrapper->CurrentStage)
+		CurrentObjective->State = EBTQuestState::Completed;
+		ObjectiveCompleted = true;
+		QuestSubSystem->ClearObjectiveTimer(ObjectiveID);
+		QuestSubSystem->UnlockDependentObjectives(*QuestWrapper, ObjectiveID, UnlockedObjectives);
+		
+		//This might advance the stage, which is announced below
+		QuestFinished = QuestSubSystem->OnObjectiveResolved(*QuestWrapper, StageIndex, *CurrentObjective, StageTransitions);
+		#if TAGFACTS_INSTALLED
 		{
-			for(auto& CurrentObjective : QuestWrapper->ObjectiveStages[i].Objectives)
-			{
-				if(!CanObjectiveBeProgressed(CurrentObjective))
-				{
-					return false;
-				}
-			
-				const float ProgressDelta = (FMath::Clamp(CurrentObjective.CurrentProgress + ProgressToAdd, 0, CurrentObjective.ProgressRequired) - CurrentObjective.CurrentProgress);
+			/**If TagFacts is installed, we increment a fact by one.
+			 * This fact matches the Objective ID, so we can track if
+			 * this objective was completed through the fact system.*/
+			UFactSubSystem::Get()->IncrementFact(ObjectiveID);
+		}
+		#endif
+	}
 
-				CurrentObjective.CurrentProgress = FMath::Clamp(CurrentObjective.CurrentProgress + ProgressToAdd,0, CurrentObjective.ProgressRequired);
-				ObjectiveProgressed = true;
+	/**The quest is up to date, from here on listeners run.
+	 * Copy what's needed, they might reallocate Quests. */
+	const FQuestObjective ProgressedObjective = *CurrentObjective;
+	const TSoftObjectPtr<UQuestAsset> QuestAsset = QuestWrapper->QuestAsset;
 
-				if(CurrentObjective.CurrentProgress == CurrentObjective.ProgressRequired)
-				{
-					CurrentObjective.State = EBTQuestState::Completed;
-					ObjectiveCompleted = true;
-					#if TAGFACTS_INSTALLED
-					{
-						/**If TagFacts is installed, we increment a fact by one.
-						 * This fact matches the Objective ID, so we can track if
-						 * this objective was completed through the fact system.*/
-						UFactSubSystem::Get()->IncrementFact(CurrentObjective.ObjectiveID);
-					}
-					#endif
-				}
-			
-				QuestSubSystem->ObjectiveProgressed.Broadcast(CurrentObjective, ProgressDelta, ObjectiveCompleted, Instigator);
+	for(const FQuestObjective& UnlockedObjective : UnlockedObjectives)
+	{
+		QuestSubSystem->ObjectiveUnlocked.Broadcast(UnlockedObjective);
+	}
 
-				#if AsyncMessageSystem_Enabled
-				if(TSharedPtr<FAsyncMessageSystemBase> Sys = UAsyncMessageWorldSubsystem::GetSharedMessageSystem(QuestSubSystem->GetWorld()))
-				{
-					Sys->QueueMessageForBroadcast(
-						FAsyncMessageId(CurrentObjective.ObjectiveID), 
-						FInstancedStruct::Make(CurrentObjective));
-				}
-				#endif
+	QuestSubSystem->ObjectiveProgressed.Broadcast(ProgressedObjective, ProgressDelta, ObjectiveCompleted, Instigator);
 
-				#if ENABLE_VISUAL_LOG
-				{
-					UE_VLOG_LOCATION(QuestSubSystem, TEXT("Quest System %s"), Verbose, UGameplayStatics::GetPlayerPawn(QuestSubSystem, 0)->GetActorLocation(),
-						10, FColor::White, TEXT("Progressed objective %s - %s / %s"),
-						*ObjectiveID.ToString(),
-						*FString::SanitizeFloat(CurrentObjective.CurrentProgress),
-						*FString::SanitizeFloat(CurrentObjective.ProgressRequired));
-				}
-				#endif
+	#if AsyncMessageSystem_Enabled
+	if(TSharedPtr<FAsyncMessageSystemBase> Sys = UAsyncMessageWorldSubsystem::GetSharedMessageSystem(QuestSubSystem->GetWorld()))
+	{
+		Sys->QueueMessageForBroadcast(
+			FAsyncMessageId(ObjectiveID), 
+			FInstancedStruct::Make(ProgressedObjective));
+	}
+	#endif
 
-				if(QuestWrapper->ObjectiveStages[i].IsComplete())
-				{
-					QuestWrapper->ObjectiveStages[i].IsActive = false;
-					
-					if(QuestWrapper->ObjectiveStages.IsValidIndex(i + 1))
-					{
-						//Label the next stage as the active one
-						QuestWrapper->ObjectiveStages[i + 1].IsActive = true;
-					}
-					
-					QuestSubSystem->QuestObjectiveStageCompleted.Broadcast(QuestWrapper->ObjectiveStages[i],
-						QuestWrapper->ObjectiveStages.IsValidIndex(i + 1) ? QuestWrapper->ObjectiveStages[i + 1] : FQuestObjectiveStage());
-				}
+	#if ENABLE_VISUAL_LOG
+	{
+		UE_VLOG_LOCATION(QuestSubSystem, TEXT("Quest System %s"), Verbose, UGameplayStatics::GetPlayerPawn(QuestSubSystem, 0)->GetActorLocation(),
+			10, FColor::White, TEXT("Progressed objective %s - %s / %s"),
+			*ObjectiveID.ToString(),
+			*FString::SanitizeFloat(ProgressedObjective.CurrentProgress),
+			*FString::SanitizeFloat(ProgressedObjective.ProgressRequired));
+	}
+	#endif
 
-				//We don't break because we need to check if the quest is completed
-			}
-		}
+	QuestSubSystem->BroadcastStageTransitions(StageTransitions);
+
+	if(QuestFinished)
+	{
+		/**That was the last stage, this will verify
+		 * and complete the quest.*/
+		CompleteQuest(QuestAsset, false, false);
+	}
 
-		if(!QuestWrapper->ObjectiveStages[i].IsComplete())
-		{
-			//At least one stage is not complete. Don't complete the quest
-			QuestCompleted = false;
-		}
-	}
-
-	// for(auto& CurrentObjective : QuestWrapper->ObjectiveStages[QuestWrapper->CurrentStage].Objectives)
-	// {
-	// 	if(CurrentObjective.ObjectiveID == ObjectiveID)
-	// 	{
-	// 		if(!CanObjectiveBeProgressed(CurrentObjective))
-	// 		{
-	// 			return false;
-	// 		}
-	// 		
-	// 		const float ProgressDelta = (FMath::Clamp(CurrentObjective.CurrentProgress + ProgressToAdd, 0, CurrentObjective.ProgressRequired) - CurrentObjective.CurrentProgress);
-	//
-	// 		CurrentObjective.CurrentProgress = FMath::Clamp(CurrentObjective.CurrentProgress + ProgressToAdd,0, CurrentObjective.ProgressRequired);
-	// 		ObjectiveProgressed = true;
-	//
-	// 		if(CurrentObjective.CurrentProgress == CurrentObjective.ProgressRequired)
-	// 		{
-	// 			CurrentObjective.State = EBTQuestState::Completed;
-	// 			ObjectiveCompleted = true;
-	// 			#if TAGFACTS_INSTALLED
-	// 			{
-	// 				/**If TagFacts is installed, we increment a fact by one.
-	// 				 * This fact matches the Objective ID, so we can track if
-	// 				 * this objective was completed through the fact system.*/
-	// 				UFactSubSystem::Get()->IncrementFact(CurrentObjective.ObjectiveID);
-	// 			}
-	// 			#endif
-	// 		}
-	// 		
-	// 		QuestSubSystem->ObjectiveProgressed.Broadcast(CurrentObjective, ProgressDelta, ObjectiveCompleted, Instigator);
-	// 		
-	// 		#if HERMES_INSTALLED
-	// 		{
-	// 			UHermesSubsystem* Hermes =UHermesSubsystem::Get();
-	// 			Hermes->BroadcastMessage(QuestSubSystem,CurrentObjective.ObjectiveID, FInstancedStruct::Make(CurrentObjective));
-	// 		}
-	// 		#endif
-	//
-	// 		#if ENABLE_VISUAL_LOG
-	// 		{
-	// 			UE_VLOG_LOCATION(QuestSubSystem, TEXT("Quest System %s"), Verbose, UGameplayStatics::GetPlayerPawn(QuestSubSystem, 0)->GetActorLocation(),
-	// 				10, FColor::White, TEXT("Progressed objective %s - %s / %s"),
-	// 				*ObjectiveID.ToString(),
-	// 				*FString::SanitizeFloat(CurrentObjective.CurrentProgress),
-	// 				*FString::SanitizeFloat(CurrentObjective.ProgressRequired));
-	// 		}
-	// 		#endif
-	//
-	// 		//We don't break because we need to check if the quest is completed
-	// 	}
-	//
-	// 	if(CurrentObjective.State == EBTQuestState::InProgress && CurrentObjective.IsOptional != true)
-	// 	{
-	// 		QuestCompleted = false;
-	// 	}
-	// }
-
-	if(QuestCompleted)
-	{
-		/**Every stage reported itself as "Complete", which means
-		 * the quest should be completed. */
-		CompleteQuest(QuestWrapper->QuestAsset, false);
-	}
-
-	return ObjectiveProgressed;
+	return true;
 }
 
 bool UQuestSystem::CanObjectiveBeProgressed(FQuestObjective Objective)
@@ -781,62 +797,89 @@ bool UQuestSystem::FailObjective(FGameplayTag Objective, bool bFailQuest)
 		return false;
 	}
 
-	const FBTQuestWrapper ObjectivesQuest = GetQuestForObjective(Objective);
-
-	FBTQuestWrapper* QuestWrapper = QuestSubSystem->Quests.Find(ObjectivesQuest.QuestAsset);
-	if(!QuestWrapper)
+	FBTQuestWrapper* QuestWrapper = nullptr;
+	int32 StageIndex = INDEX_NONE;
+	FQuestObjective* CurrentObjective = QuestSubSystem->FindObjective(Objective, QuestWrapper, StageIndex);
+	if(!CurrentObjective)
 	{
 		return false;
 	}
 
-	bool ObjectiveFailed = false;
+	const bool WasUnresolved = CurrentObjective->State == EBTQuestState::InProgress
+		|| CurrentObjective->State == EBTQuestState::Locked;
+	
+	CurrentObjective->State = EBTQuestState::Failed;
+	QuestSubSystem->ClearObjectiveTimer(Objective);
 
-	for(auto& CurrentStage : QuestWrapper->ObjectiveStages)
+	TArray<FQuestObjective> FailedObjectives;
+	QuestSubSystem->FailDependentObjectives(*QuestWrapper, Objective, FailedObjectives);
+
+	bool QuestFinished = false;
+	TArray<FQuestStageTransition> StageTransitions;
+	if(!bFailQuest && WasUnresolved)
 	{
-		for(auto& CurrentObjective : CurrentStage.Objectives)
-		{
-			if(CurrentObjective.ObjectiveID == Objective)
-			{
-				CurrentObjective.State = EBTQuestState::Failed;
+		/**A failed objective no longer holds up its stage.
+		 * This might advance the stage or complete the quest. */
+		QuestFinished = QuestSubSystem->OnObjectiveResolved(*QuestWrapper, StageIndex, *CurrentObjective, StageTransitions);
+	}
 
-				#if ENABLE_VISUAL_LOG
-				{
-					UE_VLOG_LOCATION(QuestSubSystem, TEXT("Quest System %s"), Verbose, UGameplayStatics::GetPlayerPawn(QuestSubSystem, 0)->GetActorLocation(),
-						10, FColor::White, TEXT("Failed Objective: %s"),
-						*Objective.ToString());
-				}
-				#endif
+	//Copied, listeners might reallocate the quest it lives in
+	const FQuestObjective FailedObjective = *CurrentObjective;
+	const TSoftObjectPtr<UQuestAsset> QuestAsset = QuestWrapper->QuestAsset;
 
-				QuestSubSystem->ObjectiveFailed.Broadcast(CurrentObjective);
-				
-				#if AsyncMessageSystem_Enabled
-				if(TSharedPtr<FAsyncMessageSystemBase> Sys = UAsyncMessageWorldSubsystem::GetSharedMessageSystem(QuestSubSystem->GetWorld()))
-				{
-					Sys->QueueMessageForBroadcast(
-						FAsyncMessageId(CurrentObjective.ObjectiveID), 
-						FInstancedStruct::Make(CurrentObjective));
-				}
-				#endif
-				
-				ObjectiveFailed = true;
-				break;
-			}
-		}
+	#if ENABLE_VISUAL_LOG
+	{
+		UE_VLOG_LOCATION(QuestSubSystem, TEXT("Quest System %s"), Verbose, UGameplayStatics::GetPlayerPawn(QuestSubSystem, 0)->GetActorLocation(),
+			10, FColor::White, TEXT("Failed Objective: %s"),
+			*Objective.ToString());
+	}
+	#endif
+
+	QuestSubSystem->ObjectiveFailed.Broadcast(FailedObjective);
+	
+	#if AsyncMessageSystem_Enabled
+	if(TSharedPtr<FAsyncMessageSystemBase> Sys = UAsyncMessageWorldSubsystem::GetSharedMessageSystem(QuestSubSystem->GetWorld()))
+	{
+		Sys->QueueMessageForBroadcast(
+			FAsyncMessageId(Objective), 
+			FInstancedStruct::Make(FailedObjective));
+	}
+	#endif
+
+	for(const FQuestObjective& DependentObjective : FailedObjectives)
+	{
+		QuestSubSystem->ObjectiveFailed.Broadcast(DependentObjective);
 	}
 
+	QuestSubSystem->BroadcastStageTransitions(StageTransitions);
+
 	if(bFailQuest)
 	{
-		FailQuest(QuestWrapper->QuestAsset,
+		FailQuest(QuestAsset,
 			false /*Since we are failing a specific objective, don't go ahead and fail the others.*/);
 	}
-	else
+	else if(QuestFinished)
+	{
+		CompleteQuest(QuestAsset, false, false);
+	}
+
+	return true;
+}
+
+float UQuestSystem::GetObjectiveTimeRemaining(FGameplayTag ObjectiveID)
+{
+	UQuestSystem* QuestSubSystem = UQuestSystem::Get();
+	if(!QuestSubSystem)
+	{
+		return -1;
+	}
+
+	if(const FQuestTimerHandle* Handle = QuestSubSystem->ObjectiveTimers.Find(ObjectiveID))
 	{
-		/**This will check if the quest can be completed.
-		 * If it can, then it will go ahead and complete it. */
-		CompleteQuest(QuestWrapper->QuestAsset, false, false);
+		return QuestSubSystem->ObjectiveTimerWheel.GetTimeRemaining(*Handle);
 	}
 
-	return ObjectiveFailed;
+	return -1;
 }
 
 FBTQuestWrapper UQuestSystem::CreateQuestWrapper(TSoftObjectPtr<UQuestAsset> QuestAsset)
@@ -854,14 +897,343 @@ FBTQuestWrapper UQuestSystem::CreateQuestWrapper(TSoftObjectPtr<UQuestAsset> Que
 	QuestWrapper.State = EBTQuestState::InProgress;
 	if(QuestAsset.LoadSynchronous()->ObjectiveStages.IsValidIndex(0))
 	{
-		QuestWrapper.ObjectiveStages = QuestAsset.LoadSynchronous()->ObjectiveStages;
-		QuestWrapper.ObjectiveStages[0].IsActive = true;
-		for(auto& CurrentObjective : QuestWrapper.ObjectiveStages[0].Objectives)
+		QuestWrapper.RemainingDependencies = QuestAsset->GetObjectiveGraph().InDegrees;
+		QuestWrapper.ObjectiveStages = QuestAsset->ObjectiveStages;
+		for(auto& CurrentStage : QuestWrapper.ObjectiveStages)
 		{
-			CurrentObjective.State = EBTQuestState::InProgress;
-			CurrentObjective.RootQuest = QuestAsset;
+			CurrentStage.RemainingRequired = CurrentStage.CountUnresolvedRequired();
 		}
+		
+		SetStageInProgress(QuestWrapper, 0);
 	}
 
 	return QuestWrapper;
 }
+
+void UQuestSystem::StartObjectiveTimers(const FQuestObjectiveStage& Stage)
+{
+	for(auto& CurrentObjective : Stage.Objectives)
+	{
+		if(CurrentObjective.State == EBTQuestState::InProgress)
+		{
+			StartObjectiveTimer(CurrentObjective);
+		}
+	}
+}
+
+void UQuestSystem::StartObjectiveTimer(const FQuestObjective& Objective)
+{
+	if(!Objective.IsTimed())
+	{
+		return;
+	}
+
+	//Restarting an objective restarts its timer
+	ClearObjectiveTimer(Objective.ObjectiveID);
+	ObjectiveTimers.Add(Objective.ObjectiveID, ObjectiveTimerWheel.Schedule(Objective.TimerDuration, Objective.ObjectiveID));
+
+	UE_LOG(LogQuestSystem, Log, TEXT("Started %s timer for objective %s"),
+		*StaticEnum<EBTObjectiveTimerType>()->GetNameStringByValue(static_cast<int64>(Objective.TimerType)),
+		*Objective.ObjectiveID.ToString());
+}
+
+void UQuestSystem::ClearObjectiveTimer(const FGameplayTag& ObjectiveID)
+{
+	FQuestTimerHandle Handle;
+	if(ObjectiveTimers.RemoveAndCopyValue(ObjectiveID, Handle))
+	{
+		ObjectiveTimerWheel.Cancel(Handle);
+	}
+}
+
+void UQuestSystem::ClearQuestTimers(const FBTQuestWrapper& Quest)
+{
+	if(ObjectiveTimers.IsEmpty())
+	{
+		return;
+	}
+	
+	for(auto& CurrentStage : Quest.ObjectiveStages)
+	{
+		for(auto& CurrentObjective : CurrentStage.Objectives)
+		{
+			ClearObjectiveTimer(CurrentObjective.ObjectiveID);
+		}
+	}
+}
+
+void UQuestSystem::OnObjectiveTimerExpired(const FGameplayTag& ObjectiveID)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(OnObjectiveTimerExpired)
+	
+	//The wheel already dropped the timer, only the handle is left.
+	ObjectiveTimers.Remove(ObjectiveID);
+
+	const FQuestObjective Objective = GetObjectiveByID(ObjectiveID);
+	if(Objective.State != EBTQuestState::InProgress)
+	{
+		return;
+	}
+
+	switch(Objective.TimerType)
+	{
+		case EBTObjectiveTimerType::Deadline:
+			UE_LOG(LogQuestSystem, Log, TEXT("Deadline expired for objective %s"), *ObjectiveID.ToString());
+			FailObjective(ObjectiveID, Objective.FailQuestOnDeadline);
+			break;
+		case EBTObjectiveTimerType::Duration:
+			ProgressObjective(ObjectiveID, Objective.ProgressRequired - Objective.CurrentProgress, this);
+			break;
+		default:
+			break;
+	}
+}
+
+void UQuestSystem::UnlockDependentObjectives(FBTQuestWrapper& Quest, const FGameplayTag& ObjectiveID, TArray<FQuestObjective>& OutUnlocked)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnlockDependentObjectives)
+	
+	const FQuestObjectiveGraph& ObjectiveGraph = Quest.QuestAsset.LoadSynchronous()->GetObjectiveGraph();
+	const int32 FlatIndex = ObjectiveGraph.FindObjective(ObjectiveID);
+	
+	//Wrappers from older saves might not match the current graph
+	if(FlatIndex == INDEX_NONE || Quest.RemainingDependencies.Num() != ObjectiveGraph.Locations.Num())
+	{
+		return;
+	}
+
+	for(const int32 Dependent : ObjectiveGraph.Dependents[FlatIndex])
+	{
+		if(--Quest.RemainingDependencies[Dependent] > 0)
+		{
+			continue;
+		}
+
+		const FQuestObjectiveLocation& Location = ObjectiveGraph.Locations[Dependent];
+		if(!Quest.ObjectiveStages.IsValidIndex(Location.Stage)
+			|| !Quest.ObjectiveStages[Location.Stage].Objectives.IsValidIndex(Location.Objective))
+		{
+			continue;
+		}
+		
+		FQuestObjective& DependentObjective = Quest.ObjectiveStages[Location.Stage].Objectives[Location.Objective];
+		if(DependentObjective.State != EBTQuestState::Locked)
+		{
+			continue;
+		}
+
+		DependentObjective.State = EBTQuestState::InProgress;
+		StartObjectiveTimer(DependentObjective);
+		OutUnlocked.Add(DependentObjective);
+
+		UE_LOG(LogQuestSystem, Log, TEXT("Unlocked objective %s"), *DependentObjective.ObjectiveID.ToString());
+	}
+}
+
+void UQuestSystem::FailDependentObjectives(FBTQuestWrapper& Quest, const FGameplayTag& ObjectiveID, TArray<FQuestObjective>& OutFailed)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FailDependentObjectives)
+	
+	const FQuestObjectiveGraph& ObjectiveGraph = Quest.QuestAsset.LoadSynchronous()->GetObjectiveGraph();
+	const int32 FlatIndex = ObjectiveGraph.FindObjective(ObjectiveID);
+	if(FlatIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	for(const int32 Dependent : ObjectiveGraph.Dependents[FlatIndex])
+	{
+		const FQuestObjectiveLocation& Location = ObjectiveGraph.Locations[Dependent];
+		if(!Quest.ObjectiveStages.IsValidIndex(Location.Stage)
+			|| !Quest.ObjectiveStages[Location.Stage].Objectives.IsValidIndex(Location.Objective))
+		{
+			continue;
+		}
+		
+		FQuestObjective& DependentObjective = Quest.ObjectiveStages[Location.Stage].Objectives[Location.Objective];
+		if(DependentObjective.State != EBTQuestState::Locked)
+		{
+			continue;
+		}
+
+		DependentObjective.State = EBTQuestState::Failed;
+		if(!DependentObjective.IsOptional && Quest.ObjectiveStages[Location.Stage].RemainingRequired > 0)
+		{
+			Quest.ObjectiveStages[Location.Stage].RemainingRequired--;
+		}
+		OutFailed.Add(DependentObjective);
+		
+		//Marked as failed before recursing, so cycles can't recurse forever
+		FailDependentObjectives(Quest, DependentObjective.ObjectiveID, OutFailed);
+	}
+}
+
+void UQuestSystem::RegisterObjectiveOwners(const FBTQuestWrapper& Quest)
+{
+	for(auto& CurrentStage : Quest.ObjectiveStages)
+	{
+		for(auto& CurrentObjective : CurrentStage.Objectives)
+		{
+			ObjectiveOwners.Add(CurrentObjective.ObjectiveID, Quest.QuestAsset);
+		}
+	}
+}
+
+void UQuestSystem::UnregisterObjectiveOwners(const FBTQuestWrapper& Quest)
+{
+	for(auto& CurrentStage : Quest.ObjectiveStages)
+	{
+		for(auto& CurrentObjective : CurrentStage.Objectives)
+		{
+			ObjectiveOwners.Remove(CurrentObjective.ObjectiveID);
+		}
+	}
+}
+
+FQuestObjective* UQuestSystem::FindObjective(const FGameplayTag& ObjectiveID, FBTQuestWrapper*& OutQuest, int32& OutStage)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FindObjective)
+	
+	OutQuest = nullptr;
+	OutStage = INDEX_NONE;
+	
+	const TSoftObjectPtr<UQuestAsset>* OwningQuest = ObjectiveOwners.Find(ObjectiveID);
+	FBTQuestWrapper* QuestWrapper = OwningQuest ? Quests.Find(*OwningQuest) : nullptr;
+	if(!QuestWrapper)
+	{
+		/**Quests restored from a save never went through AcceptQuest.
+		 * Fall back to searching them once and remember the owner. */
+		for(auto& CurrentQuest : Quests)
+		{
+			for(auto& CurrentStage : CurrentQuest.Value.ObjectiveStages)
+			{
+				if(CurrentStage.Objectives.ContainsByPredicate([&ObjectiveID](const FQuestObjective& Objective) { return Objective.ObjectiveID == ObjectiveID; }))
+				{
+					QuestWrapper = &CurrentQuest.Value;
+					break;
+				}
+			}
+
+			if(QuestWrapper)
+			{
+				RegisterObjectiveOwners(*QuestWrapper);
+				break;
+			}
+		}
+	}
+
+	if(!QuestWrapper)
+	{
+		return nullptr;
+	}
+
+	const FQuestObjectiveGraph& ObjectiveGraph = QuestWrapper->QuestAsset.LoadSynchronous()->GetObjectiveGraph();
+	const int32 FlatIndex = ObjectiveGraph.FindObjective(ObjectiveID);
+	if(FlatIndex != INDEX_NONE)
+	{
+		const FQuestObjectiveLocation& Location = ObjectiveGraph.Locations[FlatIndex];
+		if(QuestWrapper->ObjectiveStages.IsValidIndex(Location.Stage)
+			&& QuestWrapper->ObjectiveStages[Location.Stage].Objectives.IsValidIndex(Location.Objective)
+			&& QuestWrapper->ObjectiveStages[Location.Stage].Objectives[Location.Objective].ObjectiveID == ObjectiveID)
+		{
+			OutQuest = QuestWrapper;
+			OutStage = Location.Stage;
+			return &QuestWrapper->ObjectiveStages[Location.Stage].Objectives[Location.Objective];
+		}
+	}
+
+	//The asset has changed since the wrapper was created, search the wrapper itself.
+	for(int32 StageIndex = 0; StageIndex < QuestWrapper->ObjectiveStages.Num(); StageIndex++)
+	{
+		for(auto& CurrentObjective : QuestWrapper->ObjectiveStages[StageIndex].Objectives)
+		{
+			if(CurrentObjective.ObjectiveID == ObjectiveID)
+			{
+				OutQuest = QuestWrapper;
+				OutStage = StageIndex;
+				return &CurrentObjective;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void UQuestSystem::ActivateStage(FBTQuestWrapper& Quest, int32 StageIndex)
+{
+	SetStageInProgress(Quest, StageIndex);
+
+	//Force completed quests are walked through their stages, there's nothing left to time
+	if(Quest.State == EBTQuestState::InProgress)
+	{
+		StartObjectiveTimers(Quest.ObjectiveStages[StageIndex]);
+	}
+}
+
+bool UQuestSystem::OnObjectiveResolved(FBTQuestWrapper& Quest, int32 StageIndex, const FQuestObjective& Objective, TArray<FQuestStageTransition>& OutTransitions)
+{
+	if(!Quest.ObjectiveStages.IsValidIndex(StageIndex))
+	{
+		return false;
+	}
+	
+	FQuestObjectiveStage& Stage = Quest.ObjectiveStages[StageIndex];
+	if(Stage.RemainingRequired == INDEX_NONE)
+	{
+		//Quest from a save that predates the counters. The objective is already resolved, so it isn't counted.
+		Stage.RemainingRequired = Stage.CountUnresolvedRequired();
+	}
+	else if(!Objective.IsOptional && Stage.RemainingRequired > 0)
+	{
+		Stage.RemainingRequired--;
+	}
+
+	//Force completed quests still advance, so all their required objectives get completed
+	if(StageIndex == Quest.CurrentStage && Stage.RemainingRequired == 0 && Quest.State != EBTQuestState::Failed)
+	{
+		return CompleteStage(Quest, StageIndex, OutTransitions);
+	}
+
+	return false;
+}
+
+bool UQuestSystem::CompleteStage(FBTQuestWrapper& Quest, int32 StageIndex, TArray<FQuestStageTransition>& OutTransitions)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(CompleteStage)
+
+	/**Loops so stages without any required objectives
+	 * are completed as soon as they're reached. */
+	for(;;)
+	{
+		Quest.ObjectiveStages[StageIndex].IsActive = false;
+
+		const int32 NextStage = StageIndex + 1;
+		if(!Quest.ObjectiveStages.IsValidIndex(NextStage))
+		{
+			OutTransitions.Add({Quest.ObjectiveStages[StageIndex], FQuestObjectiveStage()});
+			return true;
+		}
+
+		Quest.CurrentStage = NextStage;
+		ActivateStage(Quest, NextStage);
+
+		UE_LOG(LogQuestSystem, Log, TEXT("Quest %s advanced to stage %i"), *Quest.QuestAsset.GetAssetName(), NextStage);
+
+		OutTransitions.Add({Quest.ObjectiveStages[StageIndex], Quest.ObjectiveStages[NextStage]});
+
+		if(Quest.ObjectiveStages[NextStage].RemainingRequired > 0)
+		{
+			return false;
+		}
+
+		StageIndex = NextStage;
+	}
+}
+
+void UQuestSystem::BroadcastStageTransitions(const TArray<FQuestStageTransition>& Transitions)
+{
+	for(const FQuestStageTransition& Transition : Transitions)
+	{
+		QuestObjectiveStageCompleted.Broadcast(Transition.CompletedStage, Transition.NewStage);
+	}
+}
@@ -7,6 +7,7 @@
 #include "Decorators/QuestTaskDecorator.h"
 #include "Engine/AssetManager.h"
 #include "Engine/StreamableManager.h"
+#include "Nodes/TaskGraphNode/TaskGraph.h"
 
 UQuestTaskNode::UQuestTaskNode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -33,6 +34,8 @@ void UQuestTaskNode::Activate_Internal()
 {
 	Super::Activate_Internal();
 
+	UTaskGraph::RegisterWithOwningGraph(this);
+
 	FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
 	Streamable.RequestAsyncLoad(QuestAsset.ToSoftObjectPath(), [this]
 	{
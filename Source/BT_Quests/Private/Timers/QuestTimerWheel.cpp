@@ -0,0 +1,203 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Timers/QuestTimerWheel.h"
+
+FQuestTimerWheel::FQuestTimerWheel(float InResolution)
+	: Resolution(FMath::Max(InResolution, UE_KINDA_SMALL_NUMBER))
+{
+	Reset();
+}
+
+FQuestTimerHandle FQuestTimerWheel::Schedule(float Delay, const FGameplayTag& Payload)
+{
+	/**The partial tick we're currently in counts towards the delay,
+	 * otherwise timers would expire up to one tick too early. */
+	const uint64 DelayTicks = FMath::Max<uint64>(1, FMath::CeilToInt64((FMath::Max(Delay, 0.f) + Accumulator) / Resolution));
+
+	FEntry NewEntry;
+	NewEntry.ExpireTick = CurrentTick + DelayTicks;
+	NewEntry.Payload = Payload;
+	NewEntry.Serial = NextSerial++;
+
+	const int32 EntryIndex = Entries.Add(NewEntry);
+	Insert(EntryIndex);
+
+	FQuestTimerHandle Handle;
+	Handle.Index = EntryIndex;
+	Handle.Serial = NewEntry.Serial;
+	return Handle;
+}
+
+bool FQuestTimerWheel::Cancel(FQuestTimerHandle& Handle)
+{
+	if(!IsHandleValid(Handle))
+	{
+		Handle.Invalidate();
+		return false;
+	}
+
+	Unlink(Handle.Index);
+	Entries.RemoveAt(Handle.Index);
+	Handle.Invalidate();
+	return true;
+}
+
+void FQuestTimerWheel::Advance(float DeltaTime, TArray<FGameplayTag>& OutExpired)
+{
+	if(IsEmpty())
+	{
+		//Nothing to wait for, so there's no point in keeping partial ticks around.
+		Accumulator = 0;
+		return;
+	}
+
+	Accumulator += DeltaTime;
+	while(Accumulator >= Resolution)
+	{
+		Accumulator -= Resolution;
+		Step(OutExpired);
+
+		if(IsEmpty())
+		{
+			Accumulator = 0;
+			break;
+		}
+	}
+}
+
+float FQuestTimerWheel::GetTimeRemaining(const FQuestTimerHandle& Handle) const
+{
+	if(!IsHandleValid(Handle))
+	{
+		return -1;
+	}
+
+	const uint64 TicksRemaining = Entries[Handle.Index].ExpireTick - CurrentTick;
+	return FMath::Max(static_cast<float>(TicksRemaining) * Resolution - Accumulator, 0.f);
+}
+
+void FQuestTimerWheel::Reset()
+{
+	Entries.Empty();
+	for(int32 Level = 0; Level < NumLevels; Level++)
+	{
+		for(int32 Slot = 0; Slot < SlotsPerLevel; Slot++)
+		{
+			Slots[Level][Slot] = INDEX_NONE;
+		}
+	}
+
+	CurrentTick = 0;
+	Accumulator = 0;
+}
+
+void FQuestTimerWheel::Insert(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	const uint64 Delta = Entry.ExpireTick - CurrentTick;
+
+	/**Find the lowest level that can hold the delta. Anything that is
+	 * beyond the range of the top level is parked in the top level slot
+	 * that is cascaded last, and gets re-inserted from there. */
+	int32 Level = NumLevels - 1;
+	int32 Slot = static_cast<int32>(((CurrentTick >> (SlotBits * Level)) + SlotMask) & SlotMask);
+	for(int32 CurrentLevel = 0; CurrentLevel < NumLevels; CurrentLevel++)
+	{
+		if(Delta < (uint64(1) << (SlotBits * (CurrentLevel + 1))))
+		{
+			Level = CurrentLevel;
+			Slot = static_cast<int32>((Entry.ExpireTick >> (SlotBits * CurrentLevel)) & SlotMask);
+			break;
+		}
+	}
+
+	Entry.Level = Level;
+	Entry.Slot = Slot;
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = Slots[Level][Slot];
+
+	if(Entry.Next != INDEX_NONE)
+	{
+		Entries[Entry.Next].Prev = EntryIndex;
+	}
+
+	Slots[Level][Slot] = EntryIndex;
+}
+
+void FQuestTimerWheel::Unlink(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+
+	if(Entry.Prev != INDEX_NONE)
+	{
+		Entries[Entry.Prev].Next = Entry.Next;
+	}
+	else
+	{
+		Slots[Entry.Level][Entry.Slot] = Entry.Next;
+	}
+
+	if(Entry.Next != INDEX_NONE)
+	{
+		Entries[Entry.Next].Prev = Entry.Prev;
+	}
+
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = INDEX_NONE;
+}
+
+void FQuestTimerWheel::Cascade(int32 Level, int32 Slot)
+{
+	int32 EntryIndex = Slots[Level][Slot];
+	Slots[Level][Slot] = INDEX_NONE;
+
+	while(EntryIndex != INDEX_NONE)
+	{
+		const int32 NextIndex = Entries[EntryIndex].Next;
+		Insert(EntryIndex);
+		EntryIndex = NextIndex;
+	}
+}
+
+void FQuestTimerWheel::Step(TArray<FGameplayTag>& OutExpired)
+{
+	CurrentTick++;
+
+	/**When a lower level wraps around, the matching slot of the level
+	 * above it is due. Cascade from the highest due level downwards,
+	 * so entries can trickle all the way down in a single step. */
+	int32 HighestDueLevel = 0;
+	for(int32 Level = 1; Level < NumLevels; Level++)
+	{
+		if((CurrentTick & ((uint64(1) << (SlotBits * Level)) - 1)) != 0)
+		{
+			break;
+		}
+		HighestDueLevel = Level;
+	}
+
+	for(int32 Level = HighestDueLevel; Level > 0; Level--)
+	{
+		Cascade(Level, static_cast<int32>((CurrentTick >> (SlotBits * Level)) & SlotMask));
+	}
+
+	const int32 Slot = static_cast<int32>(CurrentTick & SlotMask);
+	int32 EntryIndex = Slots[0][Slot];
+	Slots[0][Slot] = INDEX_NONE;
+
+	while(EntryIndex != INDEX_NONE)
+	{
+		const int32 NextIndex = Entries[EntryIndex].Next;
+		OutExpired.Add(Entries[EntryIndex].Payload);
+		Entries.RemoveAt(EntryIndex);
+		EntryIndex = NextIndex;
+	}
+}
+
+bool FQuestTimerWheel::IsHandleValid(const FQuestTimerHandle& Handle) const
+{
+	return Handle.IsValid()
+		&& Entries.IsValidIndex(Handle.Index)
+		&& Entries[Handle.Index].Serial == Handle.Serial;
+}
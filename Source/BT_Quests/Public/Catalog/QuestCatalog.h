@@ -0,0 +1,127 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "QuestSearchIndex.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "QuestCatalog.generated.h"
+
+class UQuestAsset;
+class UQuestChain;
+struct FAssetData;
+
+/**Everything the catalog knows about a quest,
+ * without the quest asset having to be loaded. */
+USTRUCT(BlueprintType)
+struct FQuestCatalogEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Quest Catalog", BlueprintReadOnly)
+	TSoftObjectPtr<UQuestAsset> Quest = nullptr;
+
+	UPROPERTY(Category = "Quest Catalog", BlueprintReadOnly)
+	FName AssetName;
+
+	UPROPERTY(Category = "Quest Catalog", BlueprintReadOnly)
+	FGameplayTag QuestID;
+
+	/**Name of the quest presented to the player,
+	 * in the culture the asset was saved in.*/
+	UPROPERTY(Category = "Quest Catalog", BlueprintReadOnly)
+	FString QuestName;
+
+	/**Names of the quest chains this quest is part of.*/
+	UPROPERTY(Category = "Quest Catalog", BlueprintReadOnly)
+	TArray<FString> ChainNames;
+};
+
+/**
+ * Index of every quest in the project, built once the asset registry
+ * has finished scanning. Only the registry tags emitted by
+ * UQuestAsset and UQuestChain are used, so no quest is loaded.
+ * Lookups by ID, name and chain are O(1).
+ */
+UCLASS(DisplayName = "Quest Catalog")
+class BT_QUESTS_API UQuestCatalog : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UQuestCatalog* Get();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	UFUNCTION(Category = "Quest Catalog", BlueprintCallable)
+	const TArray<FQuestCatalogEntry>& GetQuests();
+
+	UFUNCTION(Category = "Quest Catalog", BlueprintCallable)
+	bool FindQuestByID(FGameplayTag QuestID, FQuestCatalogEntry& OutEntry);
+
+	/**Find a quest by its asset name or the name presented to the player.
+	 * Not case-sensitive. */
+	UFUNCTION(Category = "Quest Catalog", BlueprintCallable)
+	bool FindQuestByName(const FString& Name, FQuestCatalogEntry& OutEntry);
+
+	UFUNCTION(Category = "Quest Catalog", BlueprintCallable)
+	TArray<FQuestCatalogEntry> GetQuestsInChain(const FString& ChainName);
+
+	/**Fuzzy search over quest asset names, player facing names and IDs.
+	 * Best match first. */
+	UFUNCTION(Category = "Quest Catalog", BlueprintCallable)
+	TArray<FQuestCatalogEntry> SearchQuests(const FString& Query, int32 MaxResults = 10);
+
+	/**Same as SearchQuests, but returns indices into GetQuests() and their score.*/
+	void SearchQuestIndices(const FString& Query, int32 MaxResults, TArray<FQuestSearchResult>& OutResults);
+
+	/**Index of the entry in GetQuests(), or INDEX_NONE.*/
+	int32 FindQuestIndex(const TSoftObjectPtr<UQuestAsset>& Quest);
+
+	bool IsBuilt() const
+	{
+		return Built;
+	}
+
+	/**Incremented every time the catalog is built. Entry indices
+	 * from an older build no longer match GetQuests(). */
+	uint32 GetBuildCount() const
+	{
+		return BuildCount;
+	}
+
+private:
+
+	TArray<FQuestCatalogEntry> Entries;
+
+	TMap<FGameplayTag, int32> EntriesByID;
+
+	/**Both asset names and player facing names. FString keys are not case-sensitive.*/
+	TMap<FString, int32> EntriesByName;
+
+	TMap<FSoftObjectPath, int32> EntriesByPath;
+
+	TMap<FString, TArray<int32>> EntriesByChain;
+
+	FQuestSearchIndex SearchIndex;
+
+	bool Built = false;
+
+	uint32 BuildCount = 0;
+
+	/**Scans the asset registry and rebuilds every index.*/
+	void BuildCatalog();
+
+	/**Build the catalog if it hasn't been built or was invalidated.
+	 * If the registry is still scanning, this forces it to finish. */
+	void EnsureBuilt();
+
+#if WITH_EDITOR
+	void OnAssetChanged(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+#endif
+};
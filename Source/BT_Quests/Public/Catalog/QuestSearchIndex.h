@@ -0,0 +1,61 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FQuestCatalogEntry;
+
+struct FQuestSearchResult
+{
+	/**Index of the entry in the catalog.*/
+	int32 EntryIndex = INDEX_NONE;
+
+	/**Higher is better. Exact matches score above prefix matches,
+	 * which score above substring and fuzzy matches.*/
+	float Score = 0;
+};
+
+/**
+ * Search index over the asset name, player facing name and ID of
+ * every quest in the catalog.
+ *
+ * Keys are stored lowercase and sorted, so prefix matches are a
+ * binary search followed by a contiguous range. Every key is also
+ * broken into trigrams, so substrings and typos can be found without
+ * looking at keys that share nothing with the query.
+ * Queries shorter than a trigram only match by prefix.
+ */
+struct BT_QUESTS_API FQuestSearchIndex
+{
+	void Build(const TArray<FQuestCatalogEntry>& Entries);
+
+	/**Collect up to @MaxResults entries matching @Query, best match first.*/
+	void Search(const FString& Query, int32 MaxResults, TArray<FQuestSearchResult>& OutResults) const;
+
+	void Reset();
+
+	bool IsEmpty() const
+	{
+		return Keys.Num() == 0;
+	}
+
+private:
+
+	struct FKey
+	{
+		FString Text;
+		int32 EntryIndex = INDEX_NONE;
+	};
+
+	/**Collects every unique trigram of an already lowercase string.*/
+	static void GatherTrigrams(const FString& Text, TArray<uint64>& OutTrigrams);
+
+	static float ScoreKey(const FString& Key, const FString& Query, int32 SharedTrigrams, int32 QueryTrigrams);
+
+	/**Sorted by text.*/
+	TArray<FKey> Keys;
+
+	/**Indices into Keys containing the trigram, in ascending order.*/
+	TMap<uint64, TArray<int32>> Trigrams;
+};
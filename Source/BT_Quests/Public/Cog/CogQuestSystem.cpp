@@ -6,7 +6,7 @@
 #include "QuestSystem.h"
 #include "DataAssets/QuestAsset.h"
 #include "DataAssets/QuestChain.h"
-#include "Engine/AssetManager.h"
+#include "Catalog/QuestCatalog.h"
 #include "Kismet/KismetStringLibrary.h"
 
 void FCogQuestSystem::RenderHelp()
@@ -144,27 +144,42 @@ void FCogQuestSystem::RenderContent()
 		}
 		ImGui::SameLine();
 		ImGui::Dummy(ImVec2(FCogWidgets::GetFontWidth() * 1, 0));
-		// Get the Asset Registry
-		UAssetManager& AssetManager = UAssetManager::Get();
+		ImGui::SetNextItemWidth(FCogWidgets::GetFontWidth() * 30);
+		ImGui::InputTextWithHint("##Search", "Search", SearchBuffer, IM_ARRAYSIZE(SearchBuffer));
 
-		// Retrieve the list of Primary Asset IDs for the specified type
-		TArray<FPrimaryAssetId> PrimaryAssetIdList;
-		AssetManager.GetPrimaryAssetIdList("Quests", PrimaryAssetIdList);
-
-		// Iterate over the Primary Asset IDs and print their names
-		for(const FPrimaryAssetId& AssetId : PrimaryAssetIdList)
+		/**The catalog is built once from the asset registry,
+		 * so this doesn't query the asset manager every frame. */
+		if(UQuestCatalog* QuestCatalog = UQuestCatalog::Get())
 		{
-			TSoftObjectPtr<UQuestAsset> Quest = TSoftObjectPtr<UQuestAsset>(AssetManager.GetPrimaryAssetPath(AssetId));
-			if(QuestSubSystem->Quests.Contains(Quest))
+			const TArray<FQuestCatalogEntry>& CatalogQuests = QuestCatalog->GetQuests();
+
+			//Only search again when the query changed or the catalog was rebuilt
+			const bool IsSearching = SearchBuffer[0] != '\0';
+			if(IsSearching && (FCStringAnsi::Strcmp(SearchBuffer, SearchedBuffer) != 0 || SearchedCatalogBuild != QuestCatalog->GetBuildCount()))
 			{
-				//Quest has been interacted with in some way
-				continue;
+				QuestCatalog->SearchQuestIndices(ANSI_TO_TCHAR(SearchBuffer), 25, SearchResults);
+				FCStringAnsi::Strcpy(SearchedBuffer, SearchBuffer);
+				SearchedCatalogBuild = QuestCatalog->GetBuildCount();
 			}
-			if(ImGui::CollapsingHeader(TCHAR_TO_ANSI(*AssetId.PrimaryAssetName.ToString())))
+
+			const int32 NumQuests = IsSearching ? SearchResults.Num() : CatalogQuests.Num();
+			for(int32 Index = 0; Index < NumQuests; Index++)
 			{
-				if(ImGui::Button("Accept Quest"))
+				const FQuestCatalogEntry& Entry = !IsSearching
+					? CatalogQuests[Index]
+					: CatalogQuests[SearchResults[Index].EntryIndex];
+
+				if(QuestSubSystem->Quests.Contains(Entry.Quest))
 				{
-					QuestSubSystem->AcceptQuest(Quest, true);
+					//Quest has been interacted with in some way
+					continue;
+				}
+				if(ImGui::CollapsingHeader(TCHAR_TO_ANSI(*Entry.AssetName.ToString())))
+				{
+					if(ImGui::Button("Accept Quest"))
+					{
+						QuestSubSystem->AcceptQuest(Entry.Quest, true);
+					}
 				}
 			}
 		}
@@ -6,6 +6,7 @@
 #if ENABLE_COG
 
 #include "CogWindow.h"
+#include "Catalog/QuestSearchIndex.h"
 
 class UQuestSystem;
 struct FBTQuestWrapper;
@@ -19,9 +20,17 @@ public:
 	virtual void RenderContent() override;
 
 	void CreateTableForQuest(FBTQuestWrapper* QuestWrapper, UQuestSystem* QuestSystem);
-	
-	TArray<FAssetData> AssetDataList;
-	bool SearchedAssets = false;
+
+	/**Filter for the non-active quests.*/
+	char SearchBuffer[128] = {};
+
+	/**Results for SearchedBuffer, only searched again when the query changes.*/
+	TArray<FQuestSearchResult> SearchResults;
+
+	char SearchedBuffer[128] = {};
+
+	/**Catalog build the results belong to.*/
+	uint32 SearchedCatalogBuild = 0;
 };
 
 #endif
@@ -17,6 +17,9 @@ namespace BTE
 	static FName QuestID_Tag = FName("QuestID_Tag");
 	static FName QuestName_Tag = FName("QuestName_Tag");
 	static FName QuestChainName_Tag = FName("QuestChainName_Tag");
+	/**Paths of every quest in a chain, separated by QuestChainQuests_Delimiter.*/
+	static FName QuestChainQuests_Tag = FName("QuestChainQuests_Tag");
+	static const TCHAR* const QuestChainQuests_Delimiter = TEXT(",");
 }
 
 UENUM(BlueprintType)
@@ -33,6 +36,20 @@ enum class EBTQuestState : uint8
 	Failed
 };
 
+UENUM(BlueprintType)
+enum class EBTObjectiveTimerType : uint8
+{
+	//The objective has no time limit.
+	None,
+	/**The objective must be completed before the timer
+	 * runs out, otherwise it's failed.
+	 * For example; "Deliver the package within 5 minutes" */
+	Deadline,
+	/**The objective is completed once the timer runs out.
+	 * For example; "Survive for 30 seconds" */
+	Duration
+};
+
 #pragma region QuestObjective
 USTRUCT(BlueprintType)
 struct FQuestObjective
@@ -65,6 +82,19 @@ struct FQuestObjective
 	UPROPERTY(Category = "Task", BlueprintReadOnly)
 	EBTQuestState State = EBTQuestState::Inactive;
 
+	/**Optional timer that starts as soon as this objective
+	 * is put in progress.*/
+	UPROPERTY(Category = "Timer", EditAnywhere, BlueprintReadOnly)
+	EBTObjectiveTimerType TimerType = EBTObjectiveTimerType::None;
+
+	/**How long, in seconds, until the timer expires.*/
+	UPROPERTY(Category = "Timer", EditAnywhere, BlueprintReadOnly, meta = (EditCondition = "TimerType != EBTObjectiveTimerType::None", EditConditionHides, ClampMin = "0", Units = "s"))
+	float TimerDuration = 0;
+
+	/**If the deadline expires, should the entire quest be failed as well?*/
+	UPROPERTY(Category = "Timer", EditAnywhere, BlueprintReadOnly, meta = (EditCondition = "TimerType == EBTObjectiveTimerType::Deadline", EditConditionHides))
+	bool FailQuestOnDeadline = false;
+
 	/**Arbitrary tags to associate with this objective.*/
 	UPROPERTY(Category = "Task", EditAnywhere, BlueprintReadOnly)
 	FGameplayTagContainer Tags;
@@ -81,14 +111,24 @@ struct FQuestObjective
 	 * - Return the apples and carrots to Farmer John.
 	 *
 	 * This objective would be the last one, while the
-	 * first 2 would be the dependency. */
-	// UPROPERTY(EditAnywhere, BlueprintReadOnly)
-	// FGameplayTagContainer ObjectiveDependencies;
+	 * first 2 would be the dependency.
+	 *
+	 * Stages already order objectives, so dependencies on
+	 * objectives in earlier stages are always met. Depending on
+	 * an objective in a later stage is invalid.
+	 * Until its dependencies are completed, the objective is Locked. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(Categories="QuestSystem.Quests"))
+	FGameplayTagContainer ObjectiveDependencies;
 
 	bool IsValid() const
 	{
 		return ObjectiveID.IsValid() && !RootQuest.IsNull();
 	}
+
+	bool IsTimed() const
+	{
+		return TimerType != EBTObjectiveTimerType::None && TimerDuration > 0;
+	}
 };
 
 USTRUCT(BlueprintType)
@@ -102,11 +142,38 @@ struct FQuestObjectiveStage
 	UPROPERTY(Category = "Quest", EditAnywhere, BlueprintReadOnly)
 	bool IsActive = false;
 
+	/**How many required objectives in this stage haven't been
+	 * completed or failed yet. Kept up to date by the quest system,
+	 * so stage completion doesn't require scanning the objectives.
+	 * INDEX_NONE until the stage has been counted. */
+	UPROPERTY()
+	int32 RemainingRequired = INDEX_NONE;
+
+	int32 CountUnresolvedRequired() const
+	{
+		int32 Count = 0;
+		for(auto& CurrentObject : Objectives)
+		{
+			if(!CurrentObject.IsOptional
+				&& (CurrentObject.State == EBTQuestState::InProgress
+					|| CurrentObject.State == EBTQuestState::Locked
+					|| CurrentObject.State == EBTQuestState::Inactive))
+			{
+				Count++;
+			}
+		}
+
+		return Count;
+	}
+
 	bool IsComplete() const
 	{
 		for(auto& CurrentObject : Objectives)
 		{
-			if(CurrentObject.State == EBTQuestState::InProgress)
+			/**Locked objectives are still waiting on their
+			 * dependencies, so they count as in progress.*/
+			if(CurrentObject.State == EBTQuestState::InProgress
+				|| CurrentObject.State == EBTQuestState::Locked)
 			{
 				return false;
 			}
@@ -116,6 +183,50 @@ struct FQuestObjectiveStage
 	}
 };
 
+/**Where an objective resides inside the quests stages.*/
+struct FQuestObjectiveLocation
+{
+	int32 Stage = INDEX_NONE;
+	int32 Objective = INDEX_NONE;
+};
+
+/**Precomputed dependency graph between the objectives of a quest.
+ * Objectives are addressed by their flat index, which is their
+ * position when walking all stages in order.
+ * Only dependencies inside the same stage become edges, since
+ * stages already take care of ordering everything else. */
+struct BT_QUESTS_API FQuestObjectiveGraph
+{
+	TMap<FGameplayTag, int32> ObjectiveIndices;
+
+	TArray<FQuestObjectiveLocation> Locations;
+
+	/**Flat indices of the objectives that are waiting on each objective.*/
+	TArray<TArray<int32>> Dependents;
+
+	/**How many dependencies each objective has to wait for.*/
+	TArray<int32> InDegrees;
+
+	/**All objectives sorted so that dependencies always come first.
+	 * Objectives that are part of a cycle are left out. */
+	TArray<int32> TopologicalOrder;
+
+	bool HasCycle = false;
+
+	void Build(const TArray<FQuestObjectiveStage>& Stages);
+
+	int32 FindObjective(const FGameplayTag& ObjectiveID) const
+	{
+		const int32* Index = ObjectiveIndices.Find(ObjectiveID);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	bool IsEmpty() const
+	{
+		return Locations.IsEmpty();
+	}
+};
+
 #pragma endregion
 
 /**Wrapper struct for simple serialization and data management
@@ -138,6 +249,12 @@ struct FBTQuestWrapper
 	UPROPERTY(Category = "Quest", EditAnywhere, BlueprintReadOnly)
 	int32 CurrentStage = 0;
 
+	/**How many dependencies each objective is still waiting for,
+	 * indexed by the objectives flat index in the quests
+	 * FQuestObjectiveGraph.*/
+	UPROPERTY()
+	TArray<int32> RemainingDependencies;
+
 	bool operator==(const FBTQuestWrapper& Argument) const
 	{
 		return QuestAsset == Argument.QuestAsset;
@@ -191,10 +308,24 @@ public:
 	UPROPERTY(Category = "Quest", EditAnywhere, BlueprintReadOnly)
 	bool AutoTrack = false;
 
+	/**Dependency graph of the objectives. Built once when
+	 * the asset is loaded and rebuilt whenever it's edited. */
+	const FQuestObjectiveGraph& GetObjectiveGraph() const;
+
 	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
 	
 	virtual void GetAssetRegistryTags(FAssetRegistryTagsContext Context) const override;
 
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	
+#endif
+
 	virtual bool AppearsInContextMenu_Implementation() const override
 	{
 		return GetClass() == UQuestAsset::StaticClass();
@@ -204,4 +335,10 @@ public:
 	{
 		return { FText::FromString("Quest System") };
 	}
+
+private:
+
+	mutable FQuestObjectiveGraph ObjectiveGraph;
+
+	mutable bool ObjectiveGraphBuilt = false;
 };
@@ -17,7 +17,8 @@ class BT_QUESTS_API UQuestCheatExtension : public UCheatManagerExtension
 	UQuestCheatExtension();
 
 	/**Forcefully set the state of a quest.
-	 * @PartialQuestName Full or partial name of the quest asset, NOT the in-game name.
+	 * @PartialQuestName Full or partial name of the quest asset, in-game name or ID.
+	 * The best match is used, other candidates are logged.
 	 * @NewState The new state of the quest. (Inactive, Locked, InProgress, Completed, Failed)
 	 *
 	 * Use with caution, changing a quest from Completed to Inactive aren't scenarios that
@@ -3,8 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Tickable.h"
 #include "DataAssets/QuestAsset.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Timers/QuestTimerWheel.h"
 #include "QuestSystem.generated.h"
 
 class UQuestAsset;
@@ -17,13 +19,24 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FQuestChainStarted, TSoftObjectPtr<U
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FObjectiveProgressed, FQuestObjective, Objective, float, ProgressMade, bool, Finished, UObject*, Instigator);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FObjectiveFailed, FQuestObjective, Objective);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FObjectiveUnlocked, FQuestObjective, Objective);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FQuestObjectiveStageCompleted, FQuestObjectiveStage, CompletedStage, FQuestObjectiveStage, NewStage);
 
+/**A stage that was completed and the one that followed it,
+ * waiting to be broadcast through QuestObjectiveStageCompleted. */
+struct FQuestStageTransition
+{
+	FQuestObjectiveStage CompletedStage;
+
+	/**Empty if the completed stage was the last one.*/
+	FQuestObjectiveStage NewStage;
+};
+
 /**
  * 
  */
 UCLASS(DisplayName = "Quest System")
-class BT_QUESTS_API UQuestSystem : public UGameInstanceSubsystem
+class BT_QUESTS_API UQuestSystem : public UGameInstanceSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
@@ -60,12 +73,26 @@ public:
 	UPROPERTY(Category = "Quest System|Task", BlueprintAssignable)
 	FObjectiveFailed ObjectiveFailed;
 
+	/**An objective had all its dependencies completed
+	 * and went from Locked to In Progress.*/
+	UPROPERTY(Category = "Quest System|Task", BlueprintAssignable)
+	FObjectiveUnlocked ObjectiveUnlocked;
+
 	UPROPERTY(Category = "Quest System|Task", BlueprintAssignable)
 	FQuestObjectiveStageCompleted QuestObjectiveStageCompleted;
 #pragma endregion
 
 	static UQuestSystem* Get();
 
+	virtual void Deinitialize() override;
+
+	/**Only ticks while there are timed objectives in progress.*/
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+
 //-------------------------
 #pragma region Quest
 	
@@ -160,6 +187,10 @@ public:
 	UFUNCTION(Category = "Quest System|Objective", BlueprintCallable)
 	static bool FailObjective(FGameplayTag Objective, bool bFailQuest);
 
+	/**How many seconds are left on the objectives timer.
+	 * Returns -1 if the objective has no running timer. */
+	UFUNCTION(Category = "Quest System|Objective", BlueprintPure)
+	static float GetObjectiveTimeRemaining(FGameplayTag ObjectiveID);
 	
 #pragma endregion
 	
@@ -168,5 +199,85 @@ public:
 	 * The wrapper contains all mutable data revolving a quest. */
 	UFUNCTION(Category = "Quest System|Helpers")
 	static FBTQuestWrapper CreateQuestWrapper(TSoftObjectPtr<UQuestAsset> QuestAsset);
+
+private:
+
+	/**Which quest each objective belongs to, so objectives
+	 * can be found without scanning every quest.*/
+	TMap<FGameplayTag, TSoftObjectPtr<UQuestAsset>> ObjectiveOwners;
+
+	void RegisterObjectiveOwners(const FBTQuestWrapper& Quest);
+
+	void UnregisterObjectiveOwners(const FBTQuestWrapper& Quest);
+
+	/**Find an objective and the quest and stage it resides in.
+	 * O(1) through ObjectiveOwners and the quests objective graph. */
+	FQuestObjective* FindObjective(const FGameplayTag& ObjectiveID, FBTQuestWrapper*& OutQuest, int32& OutStage);
+
+//-------------------------
+#pragma region Stages
+
+	/**Put the stage in progress and start the timers of its objectives.*/
+	void ActivateStage(FBTQuestWrapper& Quest, int32 StageIndex);
+
+	/**An objective has been completed or failed. Counts it off its stage and
+	 * if nothing required is left, advances the quest to the next stage.
+	 * Nothing is broadcast, the stages that were completed are added to
+	 * @OutTransitions. Returns true if the last stage was completed and
+	 * the quest is ready to be completed. */
+	bool OnObjectiveResolved(FBTQuestWrapper& Quest, int32 StageIndex, const FQuestObjective& Objective, TArray<FQuestStageTransition>& OutTransitions);
+
+	/**Returns true if @StageIndex was the last stage.*/
+	bool CompleteStage(FBTQuestWrapper& Quest, int32 StageIndex, TArray<FQuestStageTransition>& OutTransitions);
+
+	/**Listeners can accept quests, which reallocates Quests. Quests are
+	 * changed first and everything is broadcast afterwards, so no pointer
+	 * into Quests is used once a listener has run. */
+	void BroadcastStageTransitions(const TArray<FQuestStageTransition>& Transitions);
+
+#pragma endregion
+
+//-------------------------
+#pragma region Objective Dependencies
+
+	/**Counts down the dependencies of every objective waiting on @ObjectiveID,
+	 * unlocking those that have none left. O(out-degree).
+	 * The unlocked objectives are added to @OutUnlocked instead of being
+	 * broadcast. Listeners can accept quests, which reallocates Quests,
+	 * so they are only broadcast once nothing points into it anymore. */
+	void UnlockDependentObjectives(FBTQuestWrapper& Quest, const FGameplayTag& ObjectiveID, TArray<FQuestObjective>& OutUnlocked);
+
+	/**Objectives that are still locked behind a failed objective
+	 * can never be unlocked, so they fail along with it.
+	 * The failed objectives are added to @OutFailed. */
+	void FailDependentObjectives(FBTQuestWrapper& Quest, const FGameplayTag& ObjectiveID, TArray<FQuestObjective>& OutFailed);
+
+#pragma endregion
+
+//-------------------------
+#pragma region Objective Timers
+
+	/**Drives the deadline and duration of every timed objective.
+	 * Advancing it is O(1) per tick, regardless of how many
+	 * timed objectives are in progress. */
+	FQuestTimerWheel ObjectiveTimerWheel;
+
+	TMap<FGameplayTag, FQuestTimerHandle> ObjectiveTimers;
+
+	/**Reused every tick to avoid allocating when timers expire.*/
+	TArray<FGameplayTag> ExpiredObjectiveTimers;
+
+	/**Starts the timer of all timed objectives in the stage that are in progress.*/
+	void StartObjectiveTimers(const FQuestObjectiveStage& Stage);
+
+	void StartObjectiveTimer(const FQuestObjective& Objective);
+
+	void ClearObjectiveTimer(const FGameplayTag& ObjectiveID);
+
+	void ClearQuestTimers(const FBTQuestWrapper& Quest);
+
+	void OnObjectiveTimerExpired(const FGameplayTag& ObjectiveID);
+
+#pragma endregion
 };
 
@@ -122,7 +122,7 @@ public:
 	UFUNCTION()
 	void OnQuestObjectiveStageCompleted(FQuestObjectiveStage CompletedStage, FQuestObjectiveStage NewStage)
 	{
-		if(CompletedStage.Objectives[0].RootQuest == QuestAsset)
+		if(CompletedStage.Objectives.IsValidIndex(0) && CompletedStage.Objectives[0].RootQuest == QuestAsset)
 		{
 			QuestObjectiveStageCompleted.Broadcast(CompletedStage, NewStage);
 		}
@@ -0,0 +1,115 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Containers/SparseArray.h"
+
+/**Handle to a timer scheduled inside a FQuestTimerWheel.
+ * The serial protects against a recycled slot being
+ * cancelled by a stale handle. */
+struct FQuestTimerHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+
+	void Invalidate()
+	{
+		Index = INDEX_NONE;
+		Serial = 0;
+	}
+};
+
+/**
+ * Hierarchical timer wheel used by the quest system to drive
+ * objective deadlines and durations.
+ *
+ * Time is quantized into ticks of @Resolution seconds. Each level
+ * has 64 slots, level 0 covers the next 64 ticks, level 1 the next
+ * 64^2 ticks and so on. Timers live in a doubly linked list per slot,
+ * so scheduling and cancelling is O(1) and advancing a tick only ever
+ * looks at a single slot, no matter how many timers are active.
+ * Timers further away than the top level can reach are re-inserted
+ * when their slot is cascaded.
+ */
+struct BT_QUESTS_API FQuestTimerWheel
+{
+	explicit FQuestTimerWheel(float InResolution = 0.1f);
+
+	/**Schedule a timer that expires after @Delay seconds.
+	 * @Payload is handed back once the timer expires. */
+	FQuestTimerHandle Schedule(float Delay, const FGameplayTag& Payload);
+
+	/**Cancel a timer. Returns false if the handle was stale
+	 * or the timer already expired. */
+	bool Cancel(FQuestTimerHandle& Handle);
+
+	/**Advance the wheel and collect the payload of every
+	 * timer that expired, in order of expiry. */
+	void Advance(float DeltaTime, TArray<FGameplayTag>& OutExpired);
+
+	/**Seconds until the timer expires, or -1 if the handle is not valid.*/
+	float GetTimeRemaining(const FQuestTimerHandle& Handle) const;
+
+	bool IsEmpty() const
+	{
+		return Entries.Num() == 0;
+	}
+
+	int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+	void Reset();
+
+private:
+
+	static constexpr int32 NumLevels = 4;
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+	static constexpr uint64 SlotMask = SlotsPerLevel - 1;
+
+	struct FEntry
+	{
+		uint64 ExpireTick = 0;
+		FGameplayTag Payload;
+		uint32 Serial = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		int32 Level = 0;
+		int32 Slot = 0;
+	};
+
+	/**Links the entry into the slot matching its expire tick.*/
+	void Insert(int32 EntryIndex);
+
+	void Unlink(int32 EntryIndex);
+
+	/**Re-insert every entry of a higher level slot into the lower levels.*/
+	void Cascade(int32 Level, int32 Slot);
+
+	/**Move the wheel forward by a single tick.*/
+	void Step(TArray<FGameplayTag>& OutExpired);
+
+	bool IsHandleValid(const FQuestTimerHandle& Handle) const;
+
+	TSparseArray<FEntry> Entries;
+
+	int32 Slots[NumLevels][SlotsPerLevel];
+
+	uint64 CurrentTick = 0;
+
+	uint32 NextSerial = 1;
+
+	float Resolution = 0.1f;
+
+	/**Time that hasn't yet added up to a full tick.*/
+	float Accumulator = 0;
+};
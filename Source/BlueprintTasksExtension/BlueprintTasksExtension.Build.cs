@@ -44,6 +44,7 @@ public class BlueprintTasksExtension : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"AssetRegistry",
 				"Slate",
 				"SlateCore",
 				// ... add private dependencies that you statically link with here ...	
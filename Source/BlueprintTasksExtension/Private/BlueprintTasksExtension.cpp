@@ -8,6 +8,8 @@
 
 #define LOCTEXT_NAMESPACE "FBlueprintTasksExtensionModule"
 
+DEFINE_LOG_CATEGORY(LogTaskGraph);
+
 void FBlueprintTasksExtensionModule::StartupModule()
 {
 	#if WITH_EDITOR
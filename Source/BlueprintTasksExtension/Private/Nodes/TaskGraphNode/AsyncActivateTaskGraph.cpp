@@ -3,34 +3,146 @@
 
 #include "Nodes/TaskGraphNode/AsyncActivateTaskGraph.h"
 
+#include "BlueprintTasksExtension.h"
 #include "Engine/AssetManager.h"
 #include "Engine/StreamableManager.h"
 #include "Nodes/TaskGraphNode/TaskGraph.h"
+#include "Subsystem/TaskGraphPreloadSubsystem.h"
+#include "Subsystem/TaskGraphStartScheduler.h"
+#include "Subsystem/TaskGraphSubsystem.h"
 
-UAsyncStartTask* UAsyncStartTask::AsyncStartTaskGraph(UObject* Outer, TSoftClassPtr<UTaskGraph> TaskGraph)
+namespace
+{
+	TAsyncLoadPriority ToAsyncLoadPriority(ETaskGraphLoadPriority Priority)
+	{
+		switch(Priority)
+		{
+		case ETaskGraphLoadPriority::Low:
+			return FStreamableManager::DefaultAsyncLoadPriority - 50;
+		case ETaskGraphLoadPriority::High:
+			return FStreamableManager::AsyncLoadHighPriority;
+		default:
+			return FStreamableManager::DefaultAsyncLoadPriority;
+		}
+	}
+
+	ETaskGraphStartPriority ToStartPriority(ETaskGraphLoadPriority Priority)
+	{
+		switch(Priority)
+		{
+		case ETaskGraphLoadPriority::Low:
+			return ETaskGraphStartPriority::Low;
+		case ETaskGraphLoadPriority::High:
+			return ETaskGraphStartPriority::High;
+		default:
+			return ETaskGraphStartPriority::Normal;
+		}
+	}
+}
+
+UAsyncStartTask* UAsyncStartTask::AsyncStartTaskGraph(UObject* Outer, TSoftClassPtr<UTaskGraph> TaskGraph, ETaskGraphLoadPriority Priority)
 {
 	UAsyncStartTask* NewTask = NewObject<UAsyncStartTask>(Outer);
 	NewTask->InOuter = Outer;
 	NewTask->InTaskGraph = TaskGraph;
+	NewTask->LoadPriority = Priority;
 	return NewTask;
 }
 
 void UAsyncStartTask::Activate()
 {
-	FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
-	
-	Streamable.RequestAsyncLoad(InTaskGraph.ToSoftObjectPath(), [this]
+	UTaskGraph::RegisterWithOwningGraph(this);
+
+	if(UTaskGraphPreloadSubsystem* PreloadSubsystem = UTaskGraphPreloadSubsystem::Get())
+	{
+		PreloadSubsystem->NotifyGraphStarting(InTaskGraph);
+	}
+
+	if(InTaskGraph.Get())
+	{
+		//Class is already resident, no need to wait on the streamable manager
+		StartLoadedGraph();
+		return;
+	}
+
+	/**Bound weakly, if this action is collected before
+	 * the load finishes the callback is dropped. */
+	LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		InTaskGraph.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &UAsyncStartTask::OnGraphLoaded),
+		ToAsyncLoadPriority(LoadPriority));
+}
+
+void UAsyncStartTask::OnGraphLoaded()
+{
+	LoadHandle.Reset();
+
+	/**Loads tend to complete in bursts, so the start itself
+	 * goes through the scheduler instead of all landing now. */
+	UTaskGraphStartScheduler* Scheduler = UTaskGraphStartScheduler::Get(InOuter);
+	if(!Scheduler)
+	{
+		StartLoadedGraph();
+		return;
+	}
+
+	TWeakObjectPtr<UAsyncStartTask> WeakThis = this;
+	Scheduler->EnqueueWork(ToStartPriority(LoadPriority), [WeakThis]()
 	{
-		UTaskGraph* TaskGraph = NewObject<UTaskGraph>(InOuter, InTaskGraph.Get());
-		TaskGraph->GraphFinished.AddDynamic(this, &UAsyncStartTask::OnTaskFinished);
-		
-		TaskGraph->StartGraph();
-		GraphStarted.Broadcast(FGameplayTagContainer());
+		if(WeakThis.IsValid())
+		{
+			WeakThis->StartLoadedGraph();
+		}
 	});
 }
 
+void UAsyncStartTask::StartLoadedGraph()
+{
+	LoadHandle.Reset();
+
+	if(Cancelled)
+	{
+		return;
+	}
+
+	UClass* GraphClass = InTaskGraph.Get();
+	if(!GraphClass || !IsValid(InOuter))
+	{
+		UE_LOG(LogTaskGraph, Warning, TEXT("Failed to start task graph %s"), *InTaskGraph.ToString());
+		SetReadyToDestroy();
+		return;
+	}
+
+	UTaskGraph* TaskGraph = nullptr;
+	if(UTaskGraphSubsystem* GraphSubsystem = UTaskGraphSubsystem::Get(InOuter))
+	{
+		TaskGraph = GraphSubsystem->CreateGraph(InOuter, GraphClass);
+	}
+	else
+	{
+		//Outer isn't part of a world, the graph can't be tracked.
+		TaskGraph = NewObject<UTaskGraph>(InOuter, GraphClass);
+		TaskGraph->SetTickEnabled(TaskGraph->WantsTick);
+		UTaskGraph::RegisterWithOwningGraph(TaskGraph);
+	}
+	SpawnedTaskGraph = TaskGraph;
+	TaskGraph->GraphFinished.AddDynamic(this, &UAsyncStartTask::OnTaskFinished);
+	
+	TaskGraph->StartGraph();
+	GraphStarted.Broadcast(FGameplayTagContainer());
+}
+
 void UAsyncStartTask::Cancel()
 {
+	Cancelled = true;
+
+	if(LoadHandle.IsValid())
+	{
+		//Stops the load and the completion callback
+		LoadHandle->CancelHandle();
+		LoadHandle.Reset();
+	}
+
 	if(SpawnedTaskGraph)
 	{
 		SpawnedTaskGraph->FinishGraph();
@@ -41,5 +153,7 @@ void UAsyncStartTask::Cancel()
 
 void UAsyncStartTask::OnTaskFinished(FGameplayTagContainer FinishReasons)
 {
+	SpawnedTaskGraph = nullptr;
 	GraphFinished.Broadcast(FinishReasons);
+	SetReadyToDestroy();
 }
@@ -6,37 +6,168 @@
 #include "GameFeaturesSubsystem.h"
 #include "Engine/AssetManager.h"
 #include "Nodes/TaskGraphNode/TaskGraph.h"
+#include "Subsystem/TaskGraphPreloadSubsystem.h"
+#include "Subsystem/TaskGraphSubsystem.h"
 
 void UGFA_StartTaskGraph::OnGameFeatureLoading()
 {
 	Super::OnGameFeatureLoading();
 
-	for(auto& TaskGraph : TaskGraphsToActivate)
+	/**Keep the graphs and what they soft reference resident
+	 * for as long as the game feature is registered. */
+	if(UTaskGraphPreloadSubsystem* PreloadSubsystem = UTaskGraphPreloadSubsystem::Get())
 	{
-		UAssetManager::GetStreamableManager().RequestAsyncLoad(TaskGraph.ToSoftObjectPath());
+		PreloadSubsystem->PreloadGraphs(GetPreloadGroup(), TaskGraphsToActivate.Array());
 	}
 }
 
+void UGFA_StartTaskGraph::OnGameFeatureUnregistering()
+{
+	if(UTaskGraphPreloadSubsystem* PreloadSubsystem = UTaskGraphPreloadSubsystem::Get())
+	{
+		PreloadSubsystem->ReleaseGroup(GetPreloadGroup());
+	}
+
+	Super::OnGameFeatureUnregistering();
+}
+
+FName UGFA_StartTaskGraph::GetPreloadGroup() const
+{
+	return FName(GetPathName());
+}
+
+TArray<TSoftClassPtr<UTaskGraph>> UGFA_StartTaskGraph::GetSortedGraphs() const
+{
+	TArray<TSoftClassPtr<UTaskGraph>> SortedGraphs;
+	SortedGraphs.Reserve(TaskGraphsToActivate.Num());
+	for(const TSoftClassPtr<UTaskGraph>& TaskGraph : TaskGraphsToActivate)
+	{
+		if(!TaskGraph.IsNull())
+		{
+			SortedGraphs.Add(TaskGraph);
+		}
+	}
+
+	SortedGraphs.Sort([](const TSoftClassPtr<UTaskGraph>& A, const TSoftClassPtr<UTaskGraph>& B)
+	{
+		return A.ToSoftObjectPath().LexicalLess(B.ToSoftObjectPath());
+	});
+
+	return SortedGraphs;
+}
+
 void UGFA_StartTaskGraph::OnGameFeatureActivating(FGameFeatureActivatingContext& Context)
 {
 	Super::OnGameFeatureActivating(Context);
 
-	FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphGameFeatureActivate)
+
+	const TArray<TSoftClassPtr<UTaskGraph>> SortedGraphs = GetSortedGraphs();
+	UTaskGraphPreloadSubsystem* PreloadSubsystem = UTaskGraphPreloadSubsystem::Get();
 
 	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
 	{
 		if(Context.ShouldApplyToWorldContext(WorldContext))
 		{
-			for(auto& TaskGraph : TaskGraphsToActivate)
+			for(const TSoftClassPtr<UTaskGraph>& TaskGraph : SortedGraphs)
 			{
-				Streamable.RequestAsyncLoad(TaskGraph.ToSoftObjectPath(), [this, WorldContext, TaskGraph]
+				if(PreloadSubsystem)
 				{
-					UTaskGraph* NewTaskGraph = NewObject<UTaskGraph>(WorldContext.World(), TaskGraph.Get());
-					NewTaskGraph->StartGraph();
-				});
+					PreloadSubsystem->NotifyGraphStarting(TaskGraph);
+				}
+
+				PendingStarts.Add({WorldContext.World(), TaskGraph});
 			}
 		}
 	}
+
+	if(PendingStarts.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> PathsToLoad;
+	for(const TSoftClassPtr<UTaskGraph>& TaskGraph : SortedGraphs)
+	{
+		if(!TaskGraph.Get())
+		{
+			PathsToLoad.Add(TaskGraph.ToSoftObjectPath());
+		}
+	}
+
+	if(PathsToLoad.IsEmpty())
+	{
+		OnGraphsLoaded();
+		return;
+	}
+
+	//One request for every graph, nothing starts until all of them are resident
+	ActivationHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(PathsToLoad),
+		FStreamableDelegate::CreateUObject(this, &UGFA_StartTaskGraph::OnGraphsLoaded));
+}
+
+void UGFA_StartTaskGraph::OnGraphsLoaded()
+{
+	ActivationHandle.Reset();
+
+	TArray<FPendingGraphStart> StartsToQueue = MoveTemp(PendingStarts);
+	PendingStarts.Reset();
+
+	TWeakObjectPtr<UGFA_StartTaskGraph> WeakThis = this;
+	const float BudgetMs = OverrideStartBudget ? StartBudgetMs : -1.f;
+	for(const FPendingGraphStart& PendingStart : StartsToQueue)
+	{
+		UWorld* World = PendingStart.World.Get();
+		UTaskGraphStartScheduler* Scheduler = UTaskGraphStartScheduler::Get(World);
+		if(!Scheduler)
+		{
+			continue;
+		}
+
+		const TObjectKey<UWorld> WorldKey = World;
+		const uint32 Serial = StartSerials.FindRef(WorldKey);
+		Scheduler->EnqueueWork(StartPriority, [WeakThis, WorldKey, Serial, PendingStart]()
+		{
+			//The game feature might have been deactivated for this world while this was queued
+			if(WeakThis.IsValid() && WeakThis->StartSerials.FindRef(WorldKey) == Serial)
+			{
+				WeakThis->StartPendingGraph(PendingStart);
+			}
+		}, BudgetMs);
+	}
+}
+
+void UGFA_StartTaskGraph::StartPendingGraph(const FPendingGraphStart& PendingStart)
+{
+	UWorld* World = PendingStart.World.Get();
+	UTaskGraphSubsystem* GraphSubsystem = UTaskGraphSubsystem::Get(World);
+	if(!GraphSubsystem)
+	{
+		return;
+	}
+
+	if(UTaskGraph* NewTaskGraph = GraphSubsystem->CreateGraph(World, PendingStart.Graph.Get(), this))
+	{
+		NewTaskGraph->StartGraph();
+	}
+}
+
+void UGFA_StartTaskGraph::StopPendingStarts(UWorld* World)
+{
+	PendingStarts.RemoveAll([World](const FPendingGraphStart& PendingStart)
+	{
+		return PendingStart.World.Get() == World || !PendingStart.World.IsValid();
+	});
+
+	//The load is shared by every world, only cancel it once nothing waits on it
+	if(PendingStarts.IsEmpty() && ActivationHandle.IsValid())
+	{
+		ActivationHandle->CancelHandle();
+		ActivationHandle.Reset();
+	}
+
+	StartSerials.FindOrAdd(World)++;
 }
 
 void UGFA_StartTaskGraph::OnGameFeatureDeactivating(FGameFeatureDeactivatingContext& Context)
@@ -44,27 +175,19 @@ void UGFA_StartTaskGraph::OnGameFeatureDeactivating(FGameFeatureDeactivatingCont
 	Super::OnGameFeatureDeactivating(Context);
 
 	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphGameFeatureDeactivate)
+
 	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
 	{
 		if(Context.ShouldApplyToWorldContext(WorldContext))
 		{
-			/**TODO: Check if this is expensive
-			 * I believe all actors outers is the world,
-			 * so theoretically this would loop over ALL
-			 * actors in the level. Need to check if this
-			 * is expensive.
-			 * if it is expensive, it might be worthwhile
-			 * to create a subsystem and assign that as
-			 * the outer for level-bound task graphs. */
-			TArray<UObject*> SubObjects;
-			GetObjectsWithOuter(WorldContext.World(), SubObjects);
-
-			for(auto& CurrentObject : SubObjects)
+			//Graphs that haven't started yet in this world never will
+			StopPendingStarts(WorldContext.World());
+
+			/**Only the graphs this action started are finished,
+			 * without having to look at every object in the world. */
+			if(UTaskGraphSubsystem* GraphSubsystem = UTaskGraphSubsystem::Get(WorldContext.World()))
 			{
-				if(UTaskGraph* TaskGraph = Cast<UTaskGraph>(CurrentObject))
-				{
-					TaskGraph->FinishGraph();
-				}
+				GraphSubsystem->FinishGraphsFromSource(this);
 			}
 		}
 	}
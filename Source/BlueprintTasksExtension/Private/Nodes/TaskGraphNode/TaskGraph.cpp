@@ -3,35 +3,423 @@
 
 #include "Nodes/TaskGraphNode/TaskGraph.h"
 
+#include "Subsystem/TaskGraphSnapshot.h"
+#include "Subsystem/TaskGraphSubsystem.h"
+#include "TimerManager.h"
+#include "Engine/LatentActionManager.h"
+#include "Engine/World.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Finish Graph"), STAT_TaskGraph_FinishGraph, STATGROUP_TaskGraph);
+DECLARE_CYCLE_STAT(TEXT("Restore Graph"), STAT_TaskGraph_RestoreGraph, STATGROUP_TaskGraph);
+
+namespace
+{
+	bool IsGraphChildClass(const UClass* Class)
+	{
+		return Class->IsChildOf(UBtf_TaskForge::StaticClass())
+			|| Class->IsChildOf(UCancellableAsyncAction::StaticClass())
+			|| Class->IsChildOf(UTaskGraph::StaticClass());
+	}
+}
+
+UTaskGraph::UTaskGraph()
+	: FTickableGameObject(ETickableTickType::Never)
+{
+}
+
+void UTaskGraph::FinishGraph(FGameplayTagContainer FinishReasons)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TaskGraph_FinishGraph);
+
+	if(IsFinishing || !IsValid(this))
+	{
+		return;
+	}
+	IsFinishing = true;
+	SetTickEnabled(false);
+
+	GraphFinished.Broadcast(FinishReasons);
+
+	/**Walk backwards, so whatever was spawned last
+	 * is torn down before whatever spawned it. */
+	for(int32 Index = SpawnedObjects.Num() - 1; Index >= 0; Index--)
+	{
+		UObject* SpawnedObject = SpawnedObjects[Index].Get();
+		if(!IsValid(SpawnedObject))
+		{
+			continue;
+		}
+
+		if(UTaskGraph* ChildGraph = Cast<UTaskGraph>(SpawnedObject))
+		{
+			ChildGraph->FinishGraph();
+		}
+		else if(UBtf_TaskForge* TaskTemplate = Cast<UBtf_TaskForge>(SpawnedObject))
+		{
+			TaskTemplate->Deactivate();
+		}
+		else if(UCancellableAsyncAction* CancellableTask = Cast<UCancellableAsyncAction>(SpawnedObject))
+		{
+			CancellableTask->Cancel();
+		}
+	}
+	SpawnedObjects.Empty();
+
+	if(UTaskGraphSubsystem* GraphSubsystem = UTaskGraphSubsystem::Get(this))
+	{
+		GraphSubsystem->UnregisterGraph(this);
+		if(GraphSubsystem->ReleaseGraph(this))
+		{
+			return;
+		}
+	}
+
+	MarkAsGarbage();
+}
+
+void UTaskGraph::ResetForPool()
+{
+	//Let the graph unbind from other objects while it can still reach them
+	OnReturnedToPool();
+
+	if(UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearAllTimersForObject(this);
+		World->GetLatentActionManager().RemoveActionsForObject(this);
+	}
+
+	GraphFinished.Clear();
+	SpawnedObjects.Empty();
+	SpawnedObjectsCompactThreshold = 16;
+
+	/**Restore the variables declared in blueprint. Transient properties are
+	 * skipped, which includes the event graph's persistent frame.
+	 * That one is reset by ResetPersistentFrame once the graph's
+	 * event graph has returned, FinishGraph is usually called from it. */
+	const UObject* Defaults = GetClass()->GetDefaultObject();
+	for(TFieldIterator<FProperty> It(GetClass()); It; ++It)
+	{
+		const FProperty* Property = *It;
+		if(Property->GetOwnerClass()->HasAnyClassFlags(CLASS_Native)
+			|| Property->HasAnyPropertyFlags(CPF_Transient | CPF_InstancedReference | CPF_ContainsInstancedReference))
+		{
+			continue;
+		}
+
+		Property->CopyCompleteValue_InContainer(this, Defaults);
+	}
+
+	ResetGraph();
+
+	IsFinishing = false;
+	SetTickEnabled(false);
+}
+
+void UTaskGraph::ResetPersistentFrame()
+{
+	const UClass* GraphClass = GetClass();
+	GraphClass->DestroyPersistentUberGraphFrame(this);
+	GraphClass->CreatePersistentUberGraphFrame(this);
+}
+
+void UTaskGraph::CaptureSnapshot(FTaskGraphSnapshotEntry& OutEntry)
+{
+	OutEntry.GraphClass = GetClass();
+	OutEntry.TickEnabled = TickEnabled;
+	FTaskGraphSnapshot::SaveObjectState(this, OutEntry.Data);
+
+	OutEntry.Tasks.Reset();
+	TMap<UClass*, int32> Ordinals;
+	for(const TWeakObjectPtr<UObject>& SpawnedObject : SpawnedObjects)
+	{
+		UObject* Task = SpawnedObject.Get();
+		if(!IsValid(Task))
+		{
+			continue;
+		}
+
+		FTaskGraphTaskSnapshot& TaskSnapshot = OutEntry.Tasks.AddDefaulted_GetRef();
+		TaskSnapshot.Class = Task->GetClass();
+		TaskSnapshot.Ordinal = Ordinals.FindOrAdd(Task->GetClass())++;
+		if(UTaskGraph* ChildGraph = Cast<UTaskGraph>(Task))
+		{
+			ChildGraph->CaptureSnapshot(TaskSnapshot.ChildGraph.AddDefaulted_GetRef());
+			continue;
+		}
+
+		if(UBtf_TaskForge* TaskTemplate = Cast<UBtf_TaskForge>(Task))
+		{
+			TaskSnapshot.Active = TaskTemplate->Get_IsActive();
+		}
+		FTaskGraphSnapshot::SaveObjectState(Task, TaskSnapshot.Data);
+	}
+}
+
+void UTaskGraph::RestoreFromSnapshot(const FTaskGraphSnapshotEntry& Entry)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TaskGraph_RestoreGraph);
+
+	FTaskGraphSnapshot::LoadObjectState(this, Entry.Data);
+	SetTickEnabled(Entry.TickEnabled);
+
+	RestoreGraph();
+
+	if(Entry.Tasks.IsEmpty())
+	{
+		return;
+	}
+
+	TMap<TPair<FSoftClassPath, int32>, const FTaskGraphTaskSnapshot*> TaskSnapshots;
+	TaskSnapshots.Reserve(Entry.Tasks.Num());
+	for(const FTaskGraphTaskSnapshot& TaskSnapshot : Entry.Tasks)
+	{
+		TaskSnapshots.Add({TaskSnapshot.Class, TaskSnapshot.Ordinal}, &TaskSnapshot);
+	}
+
+	/**Copy the list, deactivating a task might spawn more.
+	 * Tasks that RestoreGraph didn't spawn again are dropped. */
+	const TArray<TWeakObjectPtr<UObject>> RestoredObjects = SpawnedObjects;
+	TMap<UClass*, int32> Ordinals;
+	for(const TWeakObjectPtr<UObject>& SpawnedObject : RestoredObjects)
+	{
+		UObject* Task = SpawnedObject.Get();
+		if(!IsValid(Task))
+		{
+			continue;
+		}
+
+		const int32 Ordinal = Ordinals.FindOrAdd(Task->GetClass())++;
+		const FTaskGraphTaskSnapshot* const* TaskSnapshot = TaskSnapshots.Find({FSoftClassPath(Task->GetClass()), Ordinal});
+		if(!TaskSnapshot)
+		{
+			continue;
+		}
+
+		//Child graphs restore their own tasks the same way
+		UTaskGraph* ChildGraph = Cast<UTaskGraph>(Task);
+		if(ChildGraph && !(*TaskSnapshot)->ChildGraph.IsEmpty())
+		{
+			ChildGraph->RestoreFromSnapshot((*TaskSnapshot)->ChildGraph[0]);
+			continue;
+		}
+
+		FTaskGraphSnapshot::LoadObjectState(Task, (*TaskSnapshot)->Data);
+
+		UBtf_TaskForge* TaskTemplate = Cast<UBtf_TaskForge>(Task);
+		if(!(*TaskSnapshot)->Active && TaskTemplate && TaskTemplate->Get_IsActive())
+		{
+			TaskTemplate->Deactivate();
+		}
+	}
+}
+
+void UTaskGraph::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if(!IsTemplate())
+	{
+		CacheOwnership();
+	}
+}
+
+void UTaskGraph::PostRename(UObject* OldOuter, const FName OldName)
+{
+	Super::PostRename(OldOuter, OldName);
+
+	//Pooled graphs move between owners
+	OwnershipCached = false;
+	CacheOwnership();
+}
+
+void UTaskGraph::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
+{
+	Super::GetAssetRegistryTags(Context);
+
+#if WITH_EDITOR
+	if(!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return;
+	}
+
+	/**Cooked asset registries don't keep package dependencies, so the
+	 * packages the graph soft references are listed in a tag for the
+	 * UTaskGraphPreloadSubsystem. The editor's registry, which the
+	 * cook uses, still has them. */
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> Dependencies;
+	AssetRegistry.GetDependencies(GetPackage()->GetFName(), Dependencies,
+		UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Soft);
+
+	TStringBuilder<512> SoftReferences;
+	for(const FName& Dependency : Dependencies)
+	{
+		if(FPackageName::IsScriptPackage(Dependency.ToString()))
+		{
+			continue;
+		}
+
+		if(SoftReferences.Len() > 0)
+		{
+			SoftReferences << BTE::TaskGraphSoftReferences_Delimiter;
+		}
+		SoftReferences << Dependency;
+	}
+	Context.AddTag(FAssetRegistryTag(BTE::TaskGraphSoftReferences_Tag, SoftReferences.ToString(), FAssetRegistryTag::TT_Hidden));
+#endif
+}
+
+void UTaskGraph::RegisterWithOwningGraph(UObject* SpawnedObject)
+{
+	if(!SpawnedObject)
+	{
+		return;
+	}
+
+	/**Tasks spawned by other tasks belong to the nearest graph.
+	 * Stop at the first outer that isn't part of a graph. */
+	for(UObject* Outer = SpawnedObject->GetOuter(); Outer; Outer = Outer->GetOuter())
+	{
+		if(UTaskGraph* Graph = Cast<UTaskGraph>(Outer))
+		{
+			if(!Graph->IsTemplate())
+			{
+				Graph->RegisterSpawnedObject(SpawnedObject);
+			}
+			return;
+		}
+
+		if(!IsGraphChildClass(Outer->GetClass()))
+		{
+			return;
+		}
+	}
+}
+
+void UTaskGraph::RegisterSpawnedObject(UObject* SpawnedObject)
+{
+	//Anything spawned while tearing down dies with the graph
+	if(IsFinishing || !SpawnedObject || SpawnedObject == this)
+	{
+		return;
+	}
+
+	if(SpawnedObjects.Num() >= SpawnedObjectsCompactThreshold)
+	{
+		SpawnedObjects.RemoveAll([](const TWeakObjectPtr<UObject>& Object)
+		{
+			return !Object.IsValid();
+		});
+		SpawnedObjectsCompactThreshold = FMath::Max(16, SpawnedObjects.Num() * 2);
+	}
+
+	SpawnedObjects.Add(SpawnedObject);
+}
+
 AActor* UTaskGraph::GetOwningActor() const
 {
-	return GetTypedOuter<AActor>();
+	if(!OwnershipCached)
+	{
+		CacheOwnership();
+	}
+
+	return CachedOwningActor.Get();
+}
+
+void UTaskGraph::SetTickEnabled(bool Enabled)
+{
+	if(IsTemplate() || TickEnabled == Enabled)
+	{
+		return;
+	}
+
+	/**Graphs that don't tick are never registered with the
+	 * tickable manager, so they cost nothing per frame. */
+	TickEnabled = Enabled;
+	SetTickableTickType(Enabled ? ETickableTickType::Conditional : ETickableTickType::Never);
+}
+
+void UTaskGraph::Tick(float DeltaTime)
+{
+	TickGraph(DeltaTime);
 }
 
 bool UTaskGraph::IsTickable() const
 {
-	return true;
+	return TickEnabled && !IsFinishing && IsValid(this);
 }
 
 TStatId UTaskGraph::GetStatId() const
 {
+#if STATS
+	if(!StatId.IsValidStat())
+	{
+		//Tickables are only ticked on the game thread
+		static TMap<TObjectKey<UClass>, TStatId> ClassStatIds;
+		TStatId& ClassStatId = ClassStatIds.FindOrAdd(GetClass());
+		if(!ClassStatId.IsValidStat())
+		{
+			ClassStatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_TaskGraph>(GetClass()->GetFName());
+		}
+		StatId = ClassStatId;
+	}
+	return StatId;
+#else
 	return TStatId();
+#endif
+}
+
+UWorld* UTaskGraph::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
 }
 
 class UWorld* UTaskGraph::GetWorld() const
 {
-	if (IsTemplate() || !GetOuter()) // We're the CDO or have no outer (?!).
+	if(!OwnershipCached)
 	{
-		return nullptr;
+		CacheOwnership();
 	}
-	
+
+	return CachedWorld.Get();
+}
+
+void UTaskGraph::InvalidateCachedOwnership()
+{
+	CachedWorld = nullptr;
+	CachedOwningActor = nullptr;
+
+	//Don't let the next GetWorld resolve the dying world again
+	OwnershipCached = true;
+}
+
+void UTaskGraph::CacheOwnership() const
+{
+	if(IsTemplate() || !GetOuter()) // We're the CDO or have no outer (?!).
+	{
+		return;
+	}
+
+	UWorld* World = nullptr;
 	for(UObject* Outer = GetOuter(); Outer; Outer = Outer->GetOuter())
 	{
-		if(Outer && Outer->GetWorld())
+		World = Outer->GetWorld();
+		if(World)
 		{
-			return Outer->GetWorld();
+			break;
 		}
 	}
 
-	return GetOuter()->GetWorld();
+	CachedWorld = World;
+	CachedOwningActor = GetTypedOuter<AActor>();
+
+	/**The outer might not be in a world yet,
+	 * in that case try again next time. */
+	OwnershipCached = World != nullptr;
 }
+
@@ -0,0 +1,285 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/TaskGraphPreloadSubsystem.h"
+
+#include "BlueprintTasksExtension.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Nodes/TaskGraphNode/TaskGraph.h"
+
+namespace
+{
+	/**Resolve the native class the blueprint derives from, so
+	 * graphs with a C++ parent below UTaskGraph are found too.
+	 * Native classes are always loaded, nothing is loaded here. */
+	bool IsTaskGraphBlueprint(const FAssetData& AssetData)
+	{
+		FString NativeParentClassPath;
+		if(!AssetData.GetTagValue(FBlueprintTags::NativeParentClassPath, NativeParentClassPath))
+		{
+			return false;
+		}
+
+		const UClass* NativeParentClass = FSoftClassPath(FPackageName::ExportTextPathToObjectPath(NativeParentClassPath)).ResolveClass();
+		return NativeParentClass && NativeParentClass->IsChildOf(UTaskGraph::StaticClass());
+	}
+
+	/**Graphs are started through their generated class, which
+	 * is what has to be resident, not the blueprint asset. */
+	FSoftObjectPath GetGraphClassPath(const FAssetData& AssetData)
+	{
+		FString GeneratedClassPath;
+		if(AssetData.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClassPath))
+		{
+			return FSoftObjectPath(FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+		}
+
+		//Cooked builds only register the generated class
+		return AssetData.GetSoftObjectPath();
+	}
+
+	/**Read the packages a graph soft references from the tag written when the graph
+	 * was saved or cooked. Falls back to the registry's package dependencies,
+	 * which only the editor keeps, for graphs that haven't been saved since. */
+	void GetSoftReferences(IAssetRegistry& AssetRegistry, FName PackageName, TArray<FName>& OutReferences)
+	{
+		TArray<FAssetData> PackageAssets;
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets);
+		for(const FAssetData& PackageAsset : PackageAssets)
+		{
+			FString SoftReferencesTag;
+			if(PackageAsset.GetTagValue(BTE::TaskGraphSoftReferences_Tag, SoftReferencesTag))
+			{
+				TArray<FString> SoftReferences;
+				SoftReferencesTag.ParseIntoArray(SoftReferences, BTE::TaskGraphSoftReferences_Delimiter);
+				for(const FString& SoftReference : SoftReferences)
+				{
+					OutReferences.Add(FName(SoftReference));
+				}
+				return;
+			}
+		}
+
+		AssetRegistry.GetDependencies(PackageName, OutReferences,
+			UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Soft);
+
+#if !WITH_EDITOR
+		if(OutReferences.IsEmpty())
+		{
+			UE_LOG(LogTaskGraph, Warning, TEXT("Task graph %s has no %s tag, resave it so its soft references can be preloaded"),
+				*PackageName.ToString(), *BTE::TaskGraphSoftReferences_Tag.ToString());
+		}
+#endif
+	}
+}
+
+UTaskGraphPreloadSubsystem* UTaskGraphPreloadSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UTaskGraphPreloadSubsystem>() : nullptr;
+}
+
+void UTaskGraphPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UTaskGraphPreloadSubsystem::OnWorldCleanup);
+}
+
+void UTaskGraphPreloadSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+	TArray<FName> GroupNames;
+	Groups.GetKeys(GroupNames);
+	for(const FName& GroupName : GroupNames)
+	{
+		ReleaseGroup(GroupName);
+	}
+
+	Super::Deinitialize();
+}
+
+void UTaskGraphPreloadSubsystem::PreloadGraphs(FName Group, const TArray<TSoftClassPtr<UTaskGraph>>& Graphs)
+{
+	PreloadGraphsInGroup(Group, Graphs, nullptr);
+}
+
+void UTaskGraphPreloadSubsystem::PreloadGraphsForWorld(UObject* WorldContext, const TArray<TSoftClassPtr<UTaskGraph>>& Graphs)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+	if(!World)
+	{
+		return;
+	}
+
+	PreloadGraphsInGroup(FName(World->GetPathName()), Graphs, World);
+}
+
+void UTaskGraphPreloadSubsystem::ReleaseGroup(FName Group)
+{
+	FTaskGraphPreloadGroup ReleasedGroup;
+	if(!Groups.RemoveAndCopyValue(Group, ReleasedGroup))
+	{
+		return;
+	}
+
+	for(TSharedPtr<FStreamableHandle>& Handle : ReleasedGroup.Handles)
+	{
+		if(Handle.IsValid())
+		{
+			//Also stops the load if it's still in flight
+			Handle->ReleaseHandle();
+		}
+	}
+
+	UE_LOG(LogTaskGraph, Verbose, TEXT("Released task graph preload group %s"), *Group.ToString());
+}
+
+bool UTaskGraphPreloadSubsystem::IsGraphPreloaded(TSoftClassPtr<UTaskGraph> Graph) const
+{
+	if(!Graph.Get())
+	{
+		return false;
+	}
+
+	const FSoftObjectPath GraphPath = Graph.ToSoftObjectPath();
+	for(const TPair<FName, FTaskGraphPreloadGroup>& Group : Groups)
+	{
+		if(Group.Value.Graphs.Contains(GraphPath))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UTaskGraphPreloadSubsystem::NotifyGraphStarting(const TSoftClassPtr<UTaskGraph>& Graph)
+{
+	if(Graph.Get())
+	{
+		PreloadHits++;
+		return true;
+	}
+
+	PreloadMisses.FindOrAdd(Graph.ToSoftObjectPath())++;
+	UE_LOG(LogTaskGraph, Log, TEXT("Task graph %s was started before it was preloaded, its start will wait on loading"),
+		*Graph.ToString());
+	return false;
+}
+
+void UTaskGraphPreloadSubsystem::PreloadGraphsInGroup(FName Group, const TArray<TSoftClassPtr<UTaskGraph>>& Graphs, UWorld* World)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphPreloadSubsystem_PreloadGraphs)
+
+	FTaskGraphPreloadGroup& PreloadGroup = Groups.FindOrAdd(Group);
+	PreloadGroup.World = World;
+
+	TArray<FSoftObjectPath> PathsToLoad;
+	TSet<FName> VisitedPackages;
+	for(const TSoftClassPtr<UTaskGraph>& Graph : Graphs)
+	{
+		if(Graph.IsNull())
+		{
+			continue;
+		}
+
+		const FSoftObjectPath GraphPath = Graph.ToSoftObjectPath();
+		bool AlreadyInGroup = false;
+		PreloadGroup.Graphs.Add(GraphPath, &AlreadyInGroup);
+		if(!AlreadyInGroup)
+		{
+			GatherPreloadPaths(GraphPath.GetLongPackageFName(), GraphPath, PathsToLoad, VisitedPackages);
+		}
+	}
+
+	if(PathsToLoad.IsEmpty())
+	{
+		return;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(PathsToLoad),
+		FStreamableDelegate(),
+		FStreamableManager::DefaultAsyncLoadPriority,
+		false,
+		false,
+		FString::Printf(TEXT("TaskGraphPreload %s"), *Group.ToString()));
+
+	if(Handle.IsValid())
+	{
+		PreloadGroup.Handles.Add(Handle);
+	}
+}
+
+void UTaskGraphPreloadSubsystem::GatherPreloadPaths(FName PackageName, const FSoftObjectPath& LoadPath, TArray<FSoftObjectPath>& OutPaths, TSet<FName>& VisitedPackages) const
+{
+	bool AlreadyVisited = false;
+	VisitedPackages.Add(PackageName, &AlreadyVisited);
+	if(AlreadyVisited)
+	{
+		return;
+	}
+
+	OutPaths.Add(LoadPath);
+
+	/**Hard references are loaded with the graph anyway,
+	 * the soft ones are what a start would otherwise wait on. */
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> Dependencies;
+	GetSoftReferences(AssetRegistry, PackageName, Dependencies);
+
+	TArray<FAssetData> DependencyAssets;
+	for(const FName& Dependency : Dependencies)
+	{
+		if(VisitedPackages.Contains(Dependency) || FPackageName::IsScriptPackage(Dependency.ToString()))
+		{
+			continue;
+		}
+
+		DependencyAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(Dependency, DependencyAssets);
+		if(DependencyAssets.IsEmpty())
+		{
+			continue;
+		}
+
+		const FAssetData& DependencyAsset = DependencyAssets[0];
+		if(DependencyAsset.AssetClassPath == UWorld::StaticClass()->GetClassPathName())
+		{
+			continue;
+		}
+
+		if(IsTaskGraphBlueprint(DependencyAsset))
+		{
+			GatherPreloadPaths(Dependency, GetGraphClassPath(DependencyAsset), OutPaths, VisitedPackages);
+		}
+		else
+		{
+			VisitedPackages.Add(Dependency);
+			OutPaths.Add(DependencyAsset.GetSoftObjectPath());
+		}
+	}
+}
+
+void UTaskGraphPreloadSubsystem::OnWorldCleanup(UWorld* World, bool SessionEnded, bool CleanupResources)
+{
+	TArray<FName> GroupsToRelease;
+	for(const TPair<FName, FTaskGraphPreloadGroup>& Group : Groups)
+	{
+		if(!Group.Value.World.IsExplicitlyNull() && (!Group.Value.World.IsValid() || Group.Value.World.Get() == World))
+		{
+			GroupsToRelease.Add(Group.Key);
+		}
+	}
+
+	for(const FName& Group : GroupsToRelease)
+	{
+		ReleaseGroup(Group);
+	}
+}
@@ -0,0 +1,35 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/TaskGraphSnapshot.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+void FTaskGraphSnapshot::SaveObjectState(UObject* Object, TArray<uint8>& OutData)
+{
+	OutData.Reset();
+	if(!Object)
+	{
+		return;
+	}
+
+	FMemoryWriter Writer(OutData, true);
+	FObjectAndNameAsStringProxyArchive Archive(Writer, true);
+	Archive.ArIsSaveGame = true;
+	Object->Serialize(Archive);
+}
+
+void FTaskGraphSnapshot::LoadObjectState(UObject* Object, const TArray<uint8>& Data)
+{
+	if(!Object || Data.IsEmpty())
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Data, true);
+	FObjectAndNameAsStringProxyArchive Archive(Reader, true);
+	Archive.ArIsSaveGame = true;
+	Object->Serialize(Archive);
+}
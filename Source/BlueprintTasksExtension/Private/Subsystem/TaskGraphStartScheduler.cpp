@@ -0,0 +1,156 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/TaskGraphStartScheduler.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Nodes/TaskGraphNode/TaskGraph.h"
+#include "Subsystem/TaskGraphSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Drain Start Queue"), STAT_TaskGraph_DrainStartQueue, STATGROUP_TaskGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Start Queue Depth"), STAT_TaskGraph_StartQueueDepth, STATGROUP_TaskGraph);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Start Queue Latency (ms)"), STAT_TaskGraph_StartQueueLatency, STATGROUP_TaskGraph);
+
+static TAutoConsoleVariable<float> CVarTaskGraphStartBudgetMs(
+	TEXT("TaskGraph.StartBudgetMs"),
+	2.0f,
+	TEXT("Milliseconds per frame spent starting queued task graphs. 0 or less drains the whole queue every frame."));
+
+UTaskGraphStartScheduler* UTaskGraphStartScheduler::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UTaskGraphStartScheduler>() : nullptr;
+}
+
+void UTaskGraphStartScheduler::Deinitialize()
+{
+	//Queued work belongs to this world, drop it with the world
+	for(FWorkQueue& Queue : Queues)
+	{
+		DEC_DWORD_STAT_BY(STAT_TaskGraph_StartQueueDepth, Queue.Num());
+		Queue.Items.Empty();
+		Queue.Head = 0;
+	}
+
+	Super::Deinitialize();
+}
+
+void UTaskGraphStartScheduler::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if(GetQueueDepth() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_TaskGraph_DrainStartQueue);
+
+	const float DefaultBudgetMs = CVarTaskGraphStartBudgetMs.GetValueOnGameThread();
+	const double StartTime = FPlatformTime::Seconds();
+
+	double TotalLatency = 0;
+	int32 Drained = 0;
+
+	for(FWorkQueue& Queue : Queues)
+	{
+		while(Queue.Num() > 0)
+		{
+			const float BudgetMs = Queue.Items[Queue.Head].BudgetMs >= 0 ? Queue.Items[Queue.Head].BudgetMs : DefaultBudgetMs;
+			if(Drained > 0 && BudgetMs > 0 && FPlatformTime::Seconds() >= StartTime + BudgetMs / 1000.0)
+			{
+				break;
+			}
+
+			/**Move the work out before running it,
+			 * it might queue more work and grow the array. */
+			FQueuedWork Item = MoveTemp(Queue.Items[Queue.Head]);
+			Queue.Head++;
+			DEC_DWORD_STAT(STAT_TaskGraph_StartQueueDepth);
+
+			TotalLatency += StartTime - Item.QueuedTime;
+			Drained++;
+
+			Item.Work();
+		}
+
+		if(Queue.Num() == 0)
+		{
+			Queue.Items.Reset();
+			Queue.Head = 0;
+		}
+	}
+
+	LastAverageLatencyMs = Drained > 0 ? static_cast<float>(TotalLatency / Drained * 1000.0) : 0.f;
+	SET_FLOAT_STAT(STAT_TaskGraph_StartQueueLatency, LastAverageLatencyMs);
+}
+
+TStatId UTaskGraphStartScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTaskGraphStartScheduler, STATGROUP_Tickables);
+}
+
+void UTaskGraphStartScheduler::EnqueueWork(ETaskGraphStartPriority Priority, TFunction<void()>&& Work, float BudgetMs)
+{
+	if(!Work)
+	{
+		return;
+	}
+
+	if(Priority == ETaskGraphStartPriority::Immediate)
+	{
+		Work();
+		return;
+	}
+
+	Queues[GetQueueIndex(Priority)].Items.Add({MoveTemp(Work), FPlatformTime::Seconds(), BudgetMs});
+	INC_DWORD_STAT(STAT_TaskGraph_StartQueueDepth);
+}
+
+void UTaskGraphStartScheduler::EnqueueGraphStart(ETaskGraphStartPriority Priority, UObject* Outer, TSubclassOf<UTaskGraph> GraphClass,
+	UObject* Source, TFunction<void(UTaskGraph*)>&& OnStarted)
+{
+	TWeakObjectPtr<UObject> WeakOuter = Outer;
+	TWeakObjectPtr<UObject> WeakSource = Source;
+	EnqueueWork(Priority, [WeakOuter, GraphClass, WeakSource, OnStarted = MoveTemp(OnStarted)]()
+	{
+		//The owner might have been destroyed while waiting
+		UObject* Outer = WeakOuter.Get();
+		UTaskGraphSubsystem* GraphSubsystem = UTaskGraphSubsystem::Get(Outer);
+		if(!Outer || !GraphSubsystem)
+		{
+			return;
+		}
+
+		if(UTaskGraph* NewGraph = GraphSubsystem->CreateGraph(Outer, GraphClass, WeakSource.Get()))
+		{
+			NewGraph->StartGraph();
+			if(OnStarted)
+			{
+				OnStarted(NewGraph);
+			}
+		}
+	});
+}
+
+void UTaskGraphStartScheduler::QueueGraphStart(UObject* Outer, TSubclassOf<UTaskGraph> GraphClass, ETaskGraphStartPriority Priority)
+{
+	EnqueueGraphStart(Priority, Outer, GraphClass);
+}
+
+int32 UTaskGraphStartScheduler::GetQueueDepth() const
+{
+	int32 Depth = 0;
+	for(const FWorkQueue& Queue : Queues)
+	{
+		Depth += Queue.Num();
+	}
+	return Depth;
+}
+
+int32 UTaskGraphStartScheduler::GetQueueIndex(ETaskGraphStartPriority Priority)
+{
+	return FMath::Clamp(static_cast<int32>(Priority) - 1, 0, UE_ARRAY_COUNT(Queues) - 1);
+}
@@ -0,0 +1,417 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+
+#include "Subsystem/TaskGraphSubsystem.h"
+
+#include "BlueprintTasksExtension.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+#include "Nodes/TaskGraphNode/TaskGraph.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Graphs"), STAT_TaskGraph_PooledGraphs, STATGROUP_TaskGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Hits"), STAT_TaskGraph_PoolHits, STATGROUP_TaskGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pool Misses"), STAT_TaskGraph_PoolMisses, STATGROUP_TaskGraph);
+DECLARE_CYCLE_STAT(TEXT("Capture Snapshot"), STAT_TaskGraph_CaptureSnapshot, STATGROUP_TaskGraph);
+DECLARE_CYCLE_STAT(TEXT("Restore Snapshot"), STAT_TaskGraph_RestoreSnapshot, STATGROUP_TaskGraph);
+
+static TAutoConsoleVariable<bool> CVarTaskGraphPooling(
+	TEXT("TaskGraph.Pooling.Enabled"),
+	true,
+	TEXT("Reuse finished task graphs of classes marked as Poolable instead of destroying them."));
+
+namespace
+{
+	template<typename KeyType>
+	void RemoveFromIndex(TMap<KeyType, TArray<UTaskGraph*>>& Index, const KeyType& Key, UTaskGraph* Graph)
+	{
+		if(TArray<UTaskGraph*>* IndexedGraphs = Index.Find(Key))
+		{
+			IndexedGraphs->RemoveSingle(Graph);
+			if(IndexedGraphs->IsEmpty())
+			{
+				Index.Remove(Key);
+			}
+		}
+	}
+
+	template<typename KeyType>
+	TArray<UTaskGraph*> FindInIndex(const TMap<KeyType, TArray<UTaskGraph*>>& Index, const KeyType& Key)
+	{
+		const TArray<UTaskGraph*>* IndexedGraphs = Index.Find(Key);
+		return IndexedGraphs ? *IndexedGraphs : TArray<UTaskGraph*>();
+	}
+}
+
+UTaskGraphSubsystem* UTaskGraphSubsystem::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UTaskGraphSubsystem>() : nullptr;
+}
+
+void UTaskGraphSubsystem::Deinitialize()
+{
+	/**The world is going away and takes every graph with it.
+	 * Don't finish them, that would run blueprint logic mid teardown. */
+	for(const TPair<TObjectPtr<UTaskGraph>, FTaskGraphRegistration>& Graph : Graphs)
+	{
+		if(Graph.Key)
+		{
+			Graph.Key->InvalidateCachedOwnership();
+		}
+	}
+
+	for(const TPair<TObjectPtr<UClass>, FTaskGraphPool>& Pool : Pools)
+	{
+		for(UTaskGraph* PooledGraph : Pool.Value.Graphs)
+		{
+			if(PooledGraph)
+			{
+				PooledGraph->InvalidateCachedOwnership();
+			}
+		}
+		DEC_DWORD_STAT_BY(STAT_TaskGraph_PooledGraphs, Pool.Value.Graphs.Num());
+	}
+	Pools.Empty();
+	PendingReleases.Empty();
+	PrewarmedClasses.Empty();
+
+	Graphs.Empty();
+	GraphsByOwner.Empty();
+	GraphsBySource.Empty();
+	GraphsByClass.Empty();
+
+	Super::Deinitialize();
+}
+
+UTaskGraph* UTaskGraphSubsystem::CreateGraph(UObject* Outer, TSubclassOf<UTaskGraph> GraphClass, UObject* Source)
+{
+	if(!Outer || !GraphClass)
+	{
+		return nullptr;
+	}
+
+	const UTaskGraph* GraphDefaults = GraphClass->GetDefaultObject<UTaskGraph>();
+	if(!GraphDefaults->Poolable || !CVarTaskGraphPooling.GetValueOnGameThread())
+	{
+		UTaskGraph* NewGraph = NewObject<UTaskGraph>(Outer, GraphClass);
+		NewGraph->SetTickEnabled(NewGraph->WantsTick);
+		UTaskGraph::RegisterWithOwningGraph(NewGraph);
+		RegisterGraph(NewGraph, Source);
+		return NewGraph;
+	}
+
+	if(GraphDefaults->PoolPrewarmCount > 0 && !PrewarmedClasses.Contains(GraphClass.Get()))
+	{
+		PrewarmPool(GraphClass, GraphDefaults->PoolPrewarmCount);
+	}
+
+	UTaskGraph* Graph = nullptr;
+	if(FTaskGraphPool* Pool = Pools.Find(GraphClass.Get()))
+	{
+		while(!Graph && !Pool->Graphs.IsEmpty())
+		{
+			Graph = Pool->Graphs.Pop(EAllowShrinking::No);
+			DEC_DWORD_STAT(STAT_TaskGraph_PooledGraphs);
+			if(!IsValid(Graph))
+			{
+				Graph = nullptr;
+			}
+		}
+	}
+
+	if(Graph)
+	{
+		//Move the graph from the pool over to its new owner
+		Graph->Rename(nullptr, Outer, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+		PoolStats.Hits++;
+		INC_DWORD_STAT(STAT_TaskGraph_PoolHits);
+	}
+	else
+	{
+		Graph = NewObject<UTaskGraph>(Outer, GraphClass);
+		PoolStats.Misses++;
+		INC_DWORD_STAT(STAT_TaskGraph_PoolMisses);
+	}
+
+	//Graphs only tick once they are handed out, never while they wait in the pool
+	Graph->SetTickEnabled(Graph->WantsTick);
+	UTaskGraph::RegisterWithOwningGraph(Graph);
+	RegisterGraph(Graph, Source);
+	return Graph;
+}
+
+void UTaskGraphSubsystem::RegisterGraph(UTaskGraph* Graph, UObject* Source)
+{
+	if(!Graph || Graphs.Contains(Graph))
+	{
+		return;
+	}
+
+	UObject* Owner = Graph->GetOuter();
+
+	FTaskGraphRegistration& Registration = Graphs.Add(Graph);
+	Registration.Owner = Owner;
+	Registration.Source = Source;
+
+	GraphsByOwner.FindOrAdd(Owner).Add(Graph);
+	GraphsByClass.FindOrAdd(Graph->GetClass()).Add(Graph);
+	if(Source)
+	{
+		GraphsBySource.FindOrAdd(Source).Add(Graph);
+	}
+
+	if(AActor* OwningActor = Cast<AActor>(Owner))
+	{
+		OwningActor->OnDestroyed.AddUniqueDynamic(this, &UTaskGraphSubsystem::OnOwningActorDestroyed);
+	}
+
+	UE_LOG(LogTaskGraph, Verbose, TEXT("Registered task graph %s (owner: %s)"), *Graph->GetName(), *GetNameSafe(Owner));
+}
+
+void UTaskGraphSubsystem::UnregisterGraph(UTaskGraph* Graph)
+{
+	FTaskGraphRegistration Registration;
+	if(!Graph || !Graphs.RemoveAndCopyValue(Graph, Registration))
+	{
+		return;
+	}
+
+	RemoveFromIndex(GraphsByOwner, Registration.Owner, Graph);
+	RemoveFromIndex(GraphsByClass, TObjectKey<UClass>(Graph->GetClass()), Graph);
+	RemoveFromIndex(GraphsBySource, Registration.Source, Graph);
+
+	UE_LOG(LogTaskGraph, Verbose, TEXT("Unregistered task graph %s"), *Graph->GetName());
+}
+
+bool UTaskGraphSubsystem::IsGraphRunning(TSubclassOf<UTaskGraph> GraphClass) const
+{
+	return GraphClass && GraphsByClass.Contains(GraphClass.Get());
+}
+
+TArray<UTaskGraph*> UTaskGraphSubsystem::GetGraphsOfClass(TSubclassOf<UTaskGraph> GraphClass) const
+{
+	return FindInIndex(GraphsByClass, TObjectKey<UClass>(GraphClass.Get()));
+}
+
+TArray<UTaskGraph*> UTaskGraphSubsystem::GetGraphsForOwner(UObject* Owner) const
+{
+	return FindInIndex(GraphsByOwner, TObjectKey<UObject>(Owner));
+}
+
+TArray<UTaskGraph*> UTaskGraphSubsystem::GetGraphsFromSource(const UObject* Source) const
+{
+	return FindInIndex(GraphsBySource, TObjectKey<UObject>(Source));
+}
+
+void UTaskGraphSubsystem::FinishGraphsFromSource(const UObject* Source)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphSubsystem_FinishGraphsFromSource)
+	FinishGraphs(GetGraphsFromSource(Source));
+}
+
+void UTaskGraphSubsystem::FinishGraphsForOwner(UObject* Owner)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphSubsystem_FinishGraphsForOwner)
+	FinishGraphs(GetGraphsForOwner(Owner));
+}
+
+FTaskGraphSnapshot UTaskGraphSubsystem::CaptureSnapshot() const
+{
+	SCOPE_CYCLE_COUNTER(STAT_TaskGraph_CaptureSnapshot);
+
+	FTaskGraphSnapshot Snapshot;
+	Snapshot.Version = FTaskGraphSnapshot::CurrentVersion;
+	Snapshot.Graphs.Reserve(Graphs.Num());
+
+	const UWorld* World = GetWorld();
+	for(const TPair<TObjectPtr<UTaskGraph>, FTaskGraphRegistration>& Graph : Graphs)
+	{
+		UTaskGraph* TaskGraph = Graph.Key;
+		if(!IsValid(TaskGraph) || Graph.Value.Source != TObjectKey<UObject>()
+			|| TaskGraph->GetTypedOuter<UTaskGraph>())
+		{
+			continue;
+		}
+
+		FTaskGraphSnapshotEntry& Entry = Snapshot.Graphs.AddDefaulted_GetRef();
+		if(TaskGraph->GetOuter() != World)
+		{
+			Entry.Owner = TaskGraph->GetOuter();
+		}
+		TaskGraph->CaptureSnapshot(Entry);
+	}
+
+	return Snapshot;
+}
+
+int32 UTaskGraphSubsystem::RestoreSnapshot(const FTaskGraphSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TaskGraph_RestoreSnapshot);
+
+	if(Snapshot.Version <= 0 || Snapshot.Version > FTaskGraphSnapshot::CurrentVersion)
+	{
+		UE_LOG(LogTaskGraph, Warning, TEXT("Can't restore task graph snapshot with version %d, current version is %d"),
+			Snapshot.Version, FTaskGraphSnapshot::CurrentVersion);
+		return 0;
+	}
+
+	UWorld* World = GetWorld();
+	int32 Restored = 0;
+	for(const FTaskGraphSnapshotEntry& Entry : Snapshot.Graphs)
+	{
+		/**Classes are expected to be resident already, a save game
+		 * is normally loaded behind a loading screen or preload group. */
+		UClass* GraphClass = Entry.GraphClass.TryLoadClass<UTaskGraph>();
+
+		UObject* Owner = World;
+		if(!Entry.Owner.IsNull())
+		{
+			//Actors placed in a level keep their path, anything spawned at runtime can't be found again
+			FSoftObjectPath OwnerPath = Entry.Owner;
+#if WITH_EDITOR
+			OwnerPath.FixupForPIE();
+#endif
+			Owner = OwnerPath.ResolveObject();
+		}
+
+		if(!GraphClass || !IsValid(Owner))
+		{
+			UE_LOG(LogTaskGraph, Warning, TEXT("Skipped restoring task graph %s, owner %s"),
+				*Entry.GraphClass.ToString(), *Entry.Owner.ToString());
+			continue;
+		}
+
+		if(UTaskGraph* Graph = CreateGraph(Owner, GraphClass))
+		{
+			Graph->RestoreFromSnapshot(Entry);
+			Restored++;
+		}
+	}
+
+	UE_LOG(LogTaskGraph, Log, TEXT("Restored %d of %d task graphs"), Restored, Snapshot.Graphs.Num());
+	return Restored;
+}
+
+void UTaskGraphSubsystem::PrewarmPool(TSubclassOf<UTaskGraph> GraphClass, int32 Count)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphSubsystem_PrewarmPool)
+
+	if(!GraphClass || GraphClass->HasAnyClassFlags(CLASS_Abstract))
+	{
+		return;
+	}
+
+	PrewarmedClasses.Add(GraphClass.Get());
+
+	const UTaskGraph* GraphDefaults = GraphClass->GetDefaultObject<UTaskGraph>();
+	if(!GraphDefaults->Poolable)
+	{
+		UE_LOG(LogTaskGraph, Warning, TEXT("Tried to prewarm %s, but it isn't poolable"), *GraphClass->GetName());
+		return;
+	}
+
+	FTaskGraphPool& Pool = Pools.FindOrAdd(GraphClass.Get());
+	const int32 ToCreate = FMath::Min(Count, GraphDefaults->MaxPoolSize - Pool.Graphs.Num());
+	for(int32 Index = 0; Index < ToCreate; Index++)
+	{
+		Pool.Graphs.Add(NewObject<UTaskGraph>(this, GraphClass));
+	}
+
+	if(ToCreate > 0)
+	{
+		PoolStats.Prewarmed += ToCreate;
+		INC_DWORD_STAT_BY(STAT_TaskGraph_PooledGraphs, ToCreate);
+	}
+}
+
+bool UTaskGraphSubsystem::ReleaseGraph(UTaskGraph* Graph)
+{
+	if(!IsValid(Graph) || !CVarTaskGraphPooling.GetValueOnGameThread())
+	{
+		return false;
+	}
+
+	const UTaskGraph* GraphDefaults = Graph->GetClass()->GetDefaultObject<UTaskGraph>();
+	if(!GraphDefaults->Poolable)
+	{
+		return false;
+	}
+
+	int32 PendingOfClass = 0;
+	for(const UTaskGraph* PendingGraph : PendingReleases)
+	{
+		if(PendingGraph && PendingGraph->GetClass() == Graph->GetClass())
+		{
+			PendingOfClass++;
+		}
+	}
+
+	const FTaskGraphPool* Pool = Pools.Find(Graph->GetClass());
+	if((Pool ? Pool->Graphs.Num() : 0) + PendingOfClass >= GraphDefaults->MaxPoolSize)
+	{
+		PoolStats.Discarded++;
+		return false;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphSubsystem_ReleaseGraph)
+
+	Graph->ResetForPool();
+
+	//The old owner might be destroyed while the graph waits in the pool
+	Graph->Rename(nullptr, this, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+
+	/**FinishGraph is usually called from the graph's own event graph,
+	 * its persistent frame can only be recreated once that has returned. */
+	if(PendingReleases.IsEmpty())
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UTaskGraphSubsystem::ReturnPendingGraphs));
+	}
+	PendingReleases.Add(Graph);
+	PoolStats.Released++;
+	return true;
+}
+
+void UTaskGraphSubsystem::ReturnPendingGraphs()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TaskGraphSubsystem_ReturnPendingGraphs)
+
+	TArray<TObjectPtr<UTaskGraph>> GraphsToReturn = MoveTemp(PendingReleases);
+	PendingReleases.Reset();
+
+	for(UTaskGraph* Graph : GraphsToReturn)
+	{
+		if(!IsValid(Graph))
+		{
+			continue;
+		}
+
+		Graph->ResetPersistentFrame();
+		Pools.FindOrAdd(Graph->GetClass()).Graphs.Add(Graph);
+		INC_DWORD_STAT(STAT_TaskGraph_PooledGraphs);
+	}
+}
+
+int32 UTaskGraphSubsystem::GetPoolSize(TSubclassOf<UTaskGraph> GraphClass) const
+{
+	const FTaskGraphPool* Pool = Pools.Find(GraphClass.Get());
+	return Pool ? Pool->Graphs.Num() : 0;
+}
+
+void UTaskGraphSubsystem::OnOwningActorDestroyed(AActor* DestroyedActor)
+{
+	FinishGraphsForOwner(DestroyedActor);
+}
+
+void UTaskGraphSubsystem::FinishGraphs(TArray<UTaskGraph*> GraphsToFinish)
+{
+	for(UTaskGraph* Graph : GraphsToFinish)
+	{
+		if(IsValid(Graph))
+		{
+			Graph->FinishGraph();
+		}
+	}
+}
@@ -2,8 +2,11 @@
 
 #pragma once
 
+#include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+BLUEPRINTTASKSEXTENSION_API DECLARE_LOG_CATEGORY_EXTERN(LogTaskGraph, Log, All);
+
 class FBlueprintTasksExtensionModule : public IModuleInterface
 {
 public:
@@ -6,12 +6,24 @@
 #include "GameplayTagContainer.h"
 #include "TaskGraph.h"
 #include "Engine/CancellableAsyncAction.h"
+#include "Engine/StreamableManager.h"
 #include "Kismet/BlueprintAsyncActionBase.h"
 #include "AsyncActivateTaskGraph.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLoadAndStartTaskGraph, FGameplayTagContainer, FinishReasons);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FTaskGraphFinished, FGameplayTagContainer, FinishReasons);
 
+/**How urgently a task graph's class should be streamed in.*/
+UENUM(BlueprintType)
+enum class ETaskGraphLoadPriority : uint8
+{
+	//Cosmetic graphs that can wait behind everything else.
+	Low,
+	Normal,
+	//Gameplay critical graphs, jump ahead in the streaming queue.
+	High
+};
+
 /**
  * 
  */
@@ -31,19 +43,35 @@ class BLUEPRINTTASKSEXTENSION_API UAsyncStartTask : public UCancellableAsyncActi
 	
 	TSoftClassPtr<UTaskGraph> InTaskGraph = nullptr;
 
+	ETaskGraphLoadPriority LoadPriority = ETaskGraphLoadPriority::Normal;
+
 	UPROPERTY()
 	TObjectPtr<UTaskGraph> SpawnedTaskGraph = nullptr;
 
+	/**Kept until the graph has started, so the load can be cancelled.*/
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	bool Cancelled = false;
+
 	/**Async load and start a task graph.
 	 * If you want to manually deactivate it,
-	 * cancel the returned task object. */
-	UFUNCTION(Category="Task Graph", BlueprintCallable, meta=(BlueprintInternalUseOnly="true", WorldContext="Outer", DefaultToSelf = "Outer"))
-	static UAsyncStartTask* AsyncStartTaskGraph(UObject* Outer, TSoftClassPtr<UTaskGraph> TaskGraph);
+	 * cancel the returned task object. Cancelling
+	 * before the graph has loaded stops the load.
+	 * @Priority Where the load goes in the streaming queue,
+	 * and where the start goes in the UTaskGraphStartScheduler. */
+	UFUNCTION(Category="Task Graph", BlueprintCallable, meta=(BlueprintInternalUseOnly="true", WorldContext="Outer", DefaultToSelf = "Outer", AdvancedDisplay = "Priority"))
+	static UAsyncStartTask* AsyncStartTaskGraph(UObject* Outer, TSoftClassPtr<UTaskGraph> TaskGraph, ETaskGraphLoadPriority Priority = ETaskGraphLoadPriority::Normal);
 
 	virtual void Activate() override;
 
 	virtual void Cancel() override;
 
+	/**Queues the start on the world's scheduler.*/
+	void OnGraphLoaded();
+
+	/**Create and start the graph, its class has to be loaded.*/
+	void StartLoadedGraph();
+
 	UFUNCTION()
 	void OnTaskFinished(FGameplayTagContainer FinishResponse);
 };
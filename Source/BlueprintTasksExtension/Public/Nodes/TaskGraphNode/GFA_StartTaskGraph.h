@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFeatureAction.h"
+#include "UObject/ObjectKey.h"
+#include "Subsystem/TaskGraphStartScheduler.h"
 
 #include "GFA_StartTaskGraph.generated.h"
 
@@ -24,9 +26,59 @@ public:
 	UPROPERTY(EditAnywhere)
 	TSet<TSoftClassPtr<UTaskGraph>> TaskGraphsToActivate;
 
+	/**All graphs are loaded in a single request and queued in order
+	 * of their path on the world's UTaskGraphStartScheduler once
+	 * everything is resident. Immediate starts them all right away. */
+	UPROPERTY(EditAnywhere)
+	ETaskGraphStartPriority StartPriority = ETaskGraphStartPriority::Normal;
+
+	/**Use StartBudgetMs instead of TaskGraph.StartBudgetMs for these starts.*/
+	UPROPERTY(EditAnywhere, meta = (InlineEditConditionToggle))
+	bool OverrideStartBudget = false;
+
+	/**Starts are only drained from the scheduler while the frame
+	 * has spent less than this many milliseconds on queued work.
+	 * At least one queued item runs every frame. 0 starts them all
+	 * in the first frame the scheduler gets to them. */
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "OverrideStartBudget", ClampMin = 0, Units = "ms"))
+	float StartBudgetMs = 0;
+
 	virtual void OnGameFeatureLoading() override;
 
+	virtual void OnGameFeatureUnregistering() override;
+
 	virtual void OnGameFeatureActivating(FGameFeatureActivatingContext& Context) override;
 
 	virtual void OnGameFeatureDeactivating(FGameFeatureDeactivatingContext& Context) override;
+
+private:
+
+	struct FPendingGraphStart
+	{
+		TWeakObjectPtr<UWorld> World = nullptr;
+		TSoftClassPtr<UTaskGraph> Graph = nullptr;
+	};
+
+	/**Starts waiting for the graphs to load.*/
+	TArray<FPendingGraphStart> PendingStarts;
+
+	TSharedPtr<FStreamableHandle> ActivationHandle;
+
+	/**Bumped for a world when its pending starts are stopped, starts
+	 * already queued on its scheduler with an older serial are dropped. */
+	TMap<TObjectKey<UWorld>, uint32> StartSerials;
+
+	/**Preload group the graphs are kept resident in.*/
+	FName GetPreloadGroup() const;
+
+	/**TaskGraphsToActivate sorted by path, so starts are deterministic.*/
+	TArray<TSoftClassPtr<UTaskGraph>> GetSortedGraphs() const;
+
+	void OnGraphsLoaded();
+
+	void StartPendingGraph(const FPendingGraphStart& PendingStart);
+
+	/**Drops the starts that haven't run yet in @World,
+	 * the ones for other worlds carry on. */
+	void StopPendingStarts(UWorld* World);
 };
@@ -10,6 +10,17 @@
 
 #include "TaskGraph.generated.h"
 
+DECLARE_STATS_GROUP(TEXT("Task Graph"), STATGROUP_TaskGraph, STATCAT_Advanced);
+
+struct FTaskGraphSnapshotEntry;
+
+namespace BTE
+{
+	/**Packages a task graph soft references, separated by TaskGraphSoftReferences_Delimiter.*/
+	static FName TaskGraphSoftReferences_Tag = FName("TaskGraphSoftReferences_Tag");
+	static const TCHAR* const TaskGraphSoftReferences_Delimiter = TEXT(",");
+}
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FGraphFinished, FGameplayTagContainer, FinishReasons);
 
 /**
@@ -31,43 +42,109 @@ class BLUEPRINTTASKSEXTENSION_API UTaskGraph : public UObject, public FTickableG
 
 public:
 
+	UTaskGraph();
+
 	UFUNCTION(Category = "Task Graph", BlueprintImplementableEvent)
 	void StartGraph();
 
 	UPROPERTY(Category = "Task Graph", BlueprintAssignable)
 	FGraphFinished GraphFinished;
 
+	/**Finished graphs of this class are kept in a pool and reused the
+	 * next time one is started, instead of being destroyed.
+	 * Blueprint variables are restored to their defaults when the graph
+	 * is returned to the pool, and the event graph's own state, such as
+	 * DoOnce, Gate and FlipFlop nodes, is recreated a frame later.
+	 * Anything else, like objects the graph created, should be reset in ResetGraph.
+	 * Delegates the graph bound on other objects are NOT cleared, unbind
+	 * them in OnReturnedToPool or a pooled graph keeps reacting to them.
+	 * Only graphs created through the UTaskGraphSubsystem are pooled. */
+	UPROPERTY(Category = "Pooling", EditDefaultsOnly)
+	bool Poolable = false;
+
+	/**How many finished graphs of this class are kept around.*/
+	UPROPERTY(Category = "Pooling", EditDefaultsOnly, meta = (EditCondition = "Poolable", ClampMin = 1))
+	int32 MaxPoolSize = 4;
+
+	/**How many graphs to create up front the first time this class is used.*/
+	UPROPERTY(Category = "Pooling", EditDefaultsOnly, meta = (EditCondition = "Poolable", ClampMin = 0))
+	int32 PoolPrewarmCount = 0;
+
+	/**Called when a poolable graph has finished, before anything is reset.
+	 * Unbind from delegates on other objects here, the variables
+	 * referencing those objects are still set at this point. */
+	UFUNCTION(Category = "Task Graph|Pooling", BlueprintNativeEvent)
+	void OnReturnedToPool();
+	virtual void OnReturnedToPool_Implementation() {}
+
+	/**Called when a poolable graph has finished and is returned to its pool,
+	 * after its blueprint variables have been restored to their defaults. */
+	UFUNCTION(Category = "Task Graph|Pooling", BlueprintNativeEvent)
+	void ResetGraph();
+	virtual void ResetGraph_Implementation() {}
+
+	/**Clears everything the previous run left behind,
+	 * so the graph can be started again. */
+	void ResetForPool();
+
+	/**Recreate the event graph's persistent frame, which holds the state of
+	 * DoOnce, Gate and FlipFlop nodes and macro temporaries. The event graph
+	 * must not be running, it would be left pointing at a freed frame. */
+	void ResetPersistentFrame();
+
 	void FinishGraph()
 	{
 		FinishGraph(FGameplayTagContainer());
 	}
 
+	/**Deactivates every task, async action and child graph spawned
+	 * inside the graph in reverse spawn order, unregisters it from
+	 * the UTaskGraphSubsystem and destroys it. */
 	UFUNCTION(Category = "Task Graph", BlueprintCallable)
-	void FinishGraph(FGameplayTagContainer FinishReasons)
+	void FinishGraph(FGameplayTagContainer FinishReasons);
+
+	virtual void PostInitProperties() override;
+
+	virtual void PostRename(UObject* OldOuter, const FName OldName) override;
+
+	virtual void GetAssetRegistryTags(FAssetRegistryTagsContext Context) const override;
+
+	/**Record a task, async action or task graph that was spawned inside this graph.*/
+	void RegisterSpawnedObject(UObject* SpawnedObject);
+
+	/**Hand @SpawnedObject to the nearest task graph in its outer chain, so the
+	 * graph deactivates it when it finishes and includes it in its snapshot.
+	 * Graphs created through the UTaskGraphSubsystem, AsyncStartTaskGraph and
+	 * the plugin's own tasks do this themselves. Other tasks should call it
+	 * when they are activated. */
+	UFUNCTION(Category = "Task Graph", BlueprintCallable, meta = (DefaultToSelf = "SpawnedObject"))
+	static void RegisterWithOwningGraph(UObject* SpawnedObject);
+
+	/**Everything spawned inside this graph, in spawn order.
+	 * Entries can be stale if the object was garbage collected. */
+	const TArray<TWeakObjectPtr<UObject>>& GetSpawnedObjects() const
 	{
-		GraphFinished.Broadcast(FinishReasons);
-
-		// UBlueprintTaskTemplate::DeactivateAllTasksRelatedToObject(this);
-		
-		TArray<UObject*> SubObjects;
-		GetObjectsWithOuter(this, SubObjects);
-
-		/**Deactivate all tasks and cancel all async actions*/
-		for(auto& CurrentObject : SubObjects)
-		{
-			if(UBtf_TaskForge* TaskTemplate = Cast<UBtf_TaskForge>(CurrentObject))
-			{
-				TaskTemplate->Deactivate();
-			}
-			else if(UCancellableAsyncAction* CancellableTask = Cast<UCancellableAsyncAction>(CurrentObject))
-			{
-				CancellableTask->Cancel();
-			}
-		}
-
-		MarkAsGarbage();
+		return SpawnedObjects;
 	}
 
+	/**Called instead of StartGraph when the graph is restored from a
+	 * save game, after its SaveGame variables have been loaded.
+	 * Spawn the tasks the graph needs without redoing its start logic,
+	 * their SaveGame variables are loaded once this returns.
+	 * By default the graph is restored without any tasks. */
+	UFUNCTION(Category = "Task Graph|Save Game", BlueprintNativeEvent)
+	void RestoreGraph();
+	virtual void RestoreGraph_Implementation() {}
+
+	/**Write the graph's and its tasks' SaveGame properties into @OutEntry.
+	 * Child graphs are captured the same way, with their own tasks. */
+	void CaptureSnapshot(FTaskGraphSnapshotEntry& OutEntry);
+
+	/**Load the graph's SaveGame properties, call RestoreGraph
+	 * and then load the SaveGame properties of the tasks it spawned.
+	 * Child graphs it spawned again are restored recursively. */
+	void RestoreFromSnapshot(const FTaskGraphSnapshotEntry& Entry);
+
 	/**Climbs the outer-chain until it finds an actor. This means that
 	 * the owner does not equal this objects outer.
 	 * For example, this might be a task graph inside another task graph,
@@ -76,14 +153,38 @@ public:
 	UFUNCTION(Category = "Task Graph", BlueprintCallable)
 	AActor* GetOwningActor() const;
 
-	/**Tick and timer support.
-	 * Do mind that this asset should not use the tick event.
-	 * It's only here to enable things like delays, async tasks, etc. */
-	virtual void Tick(float DeltaTime) override {}
+	/**Graphs don't tick unless this is enabled, delays, timers and
+	 * async tasks work without it. Ticking starts when the graph is handed out
+	 * by the UTaskGraphSubsystem or AsyncStartTaskGraph, not when it's constructed.
+	 * Can be changed at runtime with SetTickEnabled. */
+	UPROPERTY(Category = "Tick", EditDefaultsOnly)
+	bool WantsTick = false;
+
+	/**Called every frame while ticking is enabled.*/
+	UFUNCTION(Category = "Task Graph", BlueprintImplementableEvent)
+	void TickGraph(float DeltaTime);
+
+	UFUNCTION(Category = "Task Graph", BlueprintCallable)
+	void SetTickEnabled(bool Enabled);
+
+	UFUNCTION(Category = "Task Graph", BlueprintPure)
+	bool IsTickEnabled() const
+	{
+		return TickEnabled;
+	}
+
+	virtual void Tick(float DeltaTime) override;
 	virtual bool IsTickable() const override;
 	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
 
+	/**Resolved once from the outer chain and cached,
+	 * until the graph is renamed into another outer. */
 	virtual class UWorld* GetWorld() const override;
+
+	/**Drop the cached world and owning actor. Called when the world is
+	 * torn down, GetWorld and GetOwningActor return null afterwards. */
+	void InvalidateCachedOwnership();
 	
 	virtual FLinearColor GetAssetColor_Implementation() const override
 	{
@@ -94,4 +195,31 @@ public:
 	{
 		return GetClass() == UTaskGraph::StaticClass();
 	}
+
+private:
+
+	TArray<TWeakObjectPtr<UObject>> SpawnedObjects;
+
+	/**SpawnedObjects drops stale entries once it grows past this.*/
+	int32 SpawnedObjectsCompactThreshold = 16;
+
+	bool IsFinishing = false;
+
+	bool TickEnabled = false;
+
+	mutable TWeakObjectPtr<UWorld> CachedWorld = nullptr;
+
+	mutable TWeakObjectPtr<AActor> CachedOwningActor = nullptr;
+
+	/**Whether CachedWorld and CachedOwningActor are up to date.*/
+	mutable bool OwnershipCached = false;
+
+	/**Walk the outer chain once to find the world and owning actor.*/
+	void CacheOwnership() const;
+
+#if STATS
+	/**The stat of this graph's class, looked up the first time it ticks.
+	 * Every graph class gets its own stat, created by the first graph of that class. */
+	mutable TStatId StatId;
+#endif
 };
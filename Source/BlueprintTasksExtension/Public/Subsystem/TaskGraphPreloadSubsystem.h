@@ -0,0 +1,98 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "TaskGraphPreloadSubsystem.generated.h"
+
+class UTaskGraph;
+
+struct FTaskGraphPreloadGroup
+{
+	/**Handles are retained until the group is released,
+	 * so the graphs can't be unloaded in the meantime.*/
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+
+	TSet<FSoftObjectPath> Graphs;
+
+	/**Set for groups that belong to a level, the group
+	 * is released when the world is cleaned up.*/
+	TWeakObjectPtr<UWorld> World = nullptr;
+};
+
+/**
+ * Loads task graph classes ahead of time, along with the task graphs
+ * and assets they soft reference, and keeps them resident until the
+ * group they were preloaded in is released.
+ *
+ * Groups can be anything, game feature actions use their own path,
+ * levels use PreloadGraphsForWorld and are released automatically.
+ * Starting a graph that wasn't resident is recorded as a miss.
+ */
+UCLASS()
+class BLUEPRINTTASKSEXTENSION_API UTaskGraphPreloadSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UTaskGraphPreloadSubsystem* Get();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**Load the graphs and everything they soft reference,
+	 * and keep it loaded until @Group is released. */
+	UFUNCTION(Category = "Task Graph|Preload", BlueprintCallable)
+	void PreloadGraphs(FName Group, const TArray<TSoftClassPtr<UTaskGraph>>& Graphs);
+
+	/**Same as PreloadGraphs, but the group is released
+	 * once @WorldContext's world is cleaned up. */
+	UFUNCTION(Category = "Task Graph|Preload", BlueprintCallable, meta = (WorldContext = "WorldContext"))
+	void PreloadGraphsForWorld(UObject* WorldContext, const TArray<TSoftClassPtr<UTaskGraph>>& Graphs);
+
+	UFUNCTION(Category = "Task Graph|Preload", BlueprintCallable)
+	void ReleaseGroup(FName Group);
+
+	/**Has the graph been preloaded and finished loading? */
+	UFUNCTION(Category = "Task Graph|Preload", BlueprintPure)
+	bool IsGraphPreloaded(TSoftClassPtr<UTaskGraph> Graph) const;
+
+	/**Call when a graph is about to start. Returns true if its class
+	 * is already resident, otherwise the start is recorded as a miss. */
+	bool NotifyGraphStarting(const TSoftClassPtr<UTaskGraph>& Graph);
+
+	/**Graphs that were started before they were resident,
+	 * and how many times that happened. */
+	const TMap<FSoftObjectPath, int32>& GetPreloadMisses() const
+	{
+		return PreloadMisses;
+	}
+
+	int32 GetPreloadHits() const
+	{
+		return PreloadHits;
+	}
+
+private:
+
+	TMap<FName, FTaskGraphPreloadGroup> Groups;
+
+	TMap<FSoftObjectPath, int32> PreloadMisses;
+
+	int32 PreloadHits = 0;
+
+	FDelegateHandle WorldCleanupHandle;
+
+	void PreloadGraphsInGroup(FName Group, const TArray<TSoftClassPtr<UTaskGraph>>& Graphs, UWorld* World);
+
+	/**Collects the package and the packages it soft references. Other task
+	 * graphs are followed recursively, anything else is only taken one
+	 * level deep and levels are skipped, so a graph can't pull in a world. */
+	void GatherPreloadPaths(FName PackageName, const FSoftObjectPath& LoadPath, TArray<FSoftObjectPath>& OutPaths, TSet<FName>& VisitedPackages) const;
+
+	void OnWorldCleanup(UWorld* World, bool SessionEnded, bool CleanupResources);
+};
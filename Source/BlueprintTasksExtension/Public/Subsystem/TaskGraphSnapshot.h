@@ -0,0 +1,96 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TaskGraphSnapshot.generated.h"
+
+struct FTaskGraphSnapshotEntry;
+
+/**SaveGame state of a task, async action or child graph spawned inside a graph.*/
+USTRUCT(BlueprintType)
+struct FTaskGraphTaskSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	FSoftClassPath Class;
+
+	/**Which object of this class it was, in spawn order.
+	 * Tasks are matched back up by class and ordinal. */
+	UPROPERTY(SaveGame)
+	int32 Ordinal = 0;
+
+	/**Whether the task was still running. Tasks that had already
+	 * finished are deactivated again when they are restored. */
+	UPROPERTY(SaveGame)
+	bool Active = true;
+
+	/**Empty for child graphs, their state is in ChildGraph.*/
+	UPROPERTY(SaveGame)
+	TArray<uint8> Data;
+
+	/**Holds a single entry if the task is a child graph, so its
+	 * own tasks and child graphs are captured and restored too. */
+	UPROPERTY(SaveGame)
+	TArray<FTaskGraphSnapshotEntry> ChildGraph;
+};
+
+USTRUCT(BlueprintType)
+struct FTaskGraphSnapshotEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	FSoftClassPath GraphClass;
+
+	/**Path of the outer the graph was created with.
+	 * Empty if the graph was owned by the world itself. */
+	UPROPERTY(SaveGame)
+	FSoftObjectPath Owner;
+
+	/**Tick state at the time of the capture.*/
+	UPROPERTY(SaveGame)
+	bool TickEnabled = false;
+
+	/**The graph's own SaveGame properties.*/
+	UPROPERTY(SaveGame)
+	TArray<uint8> Data;
+
+	UPROPERTY(SaveGame)
+	TArray<FTaskGraphTaskSnapshot> Tasks;
+};
+
+/**
+ * Every task graph running in a world, in a form that can be stored
+ * in a save game. Only properties marked as SaveGame are stored.
+ * Captured and restored through the UTaskGraphSubsystem.
+ */
+USTRUCT(BlueprintType)
+struct BLUEPRINTTASKSEXTENSION_API FTaskGraphSnapshot
+{
+	GENERATED_BODY()
+
+	/**Bump when the layout of the snapshot changes.
+	 * 1: Initial version.
+	 * 2: Child graphs are captured with their own tasks. */
+	static constexpr int32 CurrentVersion = 2;
+
+	/**0 for a snapshot that was never captured.*/
+	UPROPERTY(SaveGame)
+	int32 Version = 0;
+
+	UPROPERTY(SaveGame)
+	TArray<FTaskGraphSnapshotEntry> Graphs;
+
+	bool IsEmpty() const
+	{
+		return Graphs.IsEmpty();
+	}
+
+	/**Write @Object's SaveGame properties into @OutData.*/
+	static void SaveObjectState(UObject* Object, TArray<uint8>& OutData);
+
+	/**Read SaveGame properties written by SaveObjectState back into @Object.*/
+	static void LoadObjectState(UObject* Object, const TArray<uint8>& Data);
+};
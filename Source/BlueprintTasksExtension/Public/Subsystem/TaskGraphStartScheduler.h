@@ -0,0 +1,99 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TaskGraphStartScheduler.generated.h"
+
+class UTaskGraph;
+
+UENUM(BlueprintType)
+enum class ETaskGraphStartPriority : uint8
+{
+	//Runs right away, ignoring the frame budget.
+	Immediate,
+	High,
+	Normal,
+	//Cosmetic work that can wait for a quiet frame.
+	Low
+};
+
+/**
+ * Spreads task graph starts, and any other work that would otherwise
+ * all land in the same frame, over several frames.
+ *
+ * Work is queued per priority and drained from the highest priority
+ * down until the per-frame budget (TaskGraph.StartBudgetMs, or the
+ * budget the work was queued with) is spent.
+ * At least one item runs every frame, so nothing can starve.
+ */
+UCLASS()
+class BLUEPRINTTASKSEXTENSION_API UTaskGraphStartScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UTaskGraphStartScheduler* Get(const UObject* WorldContext);
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**Queue any work, for example activating a task.
+	 * @BudgetMs overrides TaskGraph.StartBudgetMs for this work, it only runs
+	 * while the frame has spent less than that draining the queue.
+	 * 0 runs it in the next drain regardless, negative uses the cvar. */
+	void EnqueueWork(ETaskGraphStartPriority Priority, TFunction<void()>&& Work, float BudgetMs = -1.f);
+
+	/**Queue creating and starting a task graph through the UTaskGraphSubsystem.
+	 * @Source is passed on to the subsystem.
+	 * @OnStarted is called with the graph once it has started. */
+	void EnqueueGraphStart(ETaskGraphStartPriority Priority, UObject* Outer, TSubclassOf<UTaskGraph> GraphClass,
+		UObject* Source = nullptr, TFunction<void(UTaskGraph*)>&& OnStarted = nullptr);
+
+	UFUNCTION(Category = "Task Graph", BlueprintCallable)
+	void QueueGraphStart(UObject* Outer, TSubclassOf<UTaskGraph> GraphClass, ETaskGraphStartPriority Priority = ETaskGraphStartPriority::Normal);
+
+	UFUNCTION(Category = "Task Graph", BlueprintPure)
+	int32 GetQueueDepth() const;
+
+	/**Average time the work drained last frame spent in the queue.*/
+	UFUNCTION(Category = "Task Graph", BlueprintPure)
+	float GetLastAverageLatencyMs() const
+	{
+		return LastAverageLatencyMs;
+	}
+
+private:
+
+	struct FQueuedWork
+	{
+		TFunction<void()> Work;
+		double QueuedTime = 0;
+		float BudgetMs = -1.f;
+	};
+
+	struct FWorkQueue
+	{
+		TArray<FQueuedWork> Items;
+
+		/**Items before this have already run.*/
+		int32 Head = 0;
+
+		int32 Num() const
+		{
+			return Items.Num() - Head;
+		}
+	};
+
+	/**One per priority, except Immediate which never queues.*/
+	FWorkQueue Queues[3];
+
+	float LastAverageLatencyMs = 0;
+
+	static int32 GetQueueIndex(ETaskGraphStartPriority Priority);
+};
@@ -0,0 +1,192 @@
+﻿// Copyright (C) Varian Daemon 2025. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TaskGraphSnapshot.h"
+#include "UObject/ObjectKey.h"
+#include "TaskGraphSubsystem.generated.h"
+
+class UTaskGraph;
+
+USTRUCT()
+struct FTaskGraphRegistration
+{
+	GENERATED_BODY()
+
+	/**The outer the graph was created with.
+	 * Keys are only compared, never resolved, so they
+	 * stay usable after the owner is destroyed. */
+	TObjectKey<UObject> Owner;
+
+	/**Whatever started the graph, for example a game feature action.
+	 * Can be null. */
+	TObjectKey<UObject> Source;
+};
+
+USTRUCT()
+struct FTaskGraphPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UTaskGraph>> Graphs;
+};
+
+USTRUCT(BlueprintType)
+struct FTaskGraphPoolStats
+{
+	GENERATED_BODY()
+
+	/**Graphs that were started by reusing a pooled graph.
+	 * Each one is a UObject that didn't have to be created and collected.*/
+	UPROPERTY(Category = "Task Graph", BlueprintReadOnly)
+	int32 Hits = 0;
+
+	/**Graphs of a poolable class that had to be created because the pool was empty.*/
+	UPROPERTY(Category = "Task Graph", BlueprintReadOnly)
+	int32 Misses = 0;
+
+	/**Finished graphs returned to a pool.*/
+	UPROPERTY(Category = "Task Graph", BlueprintReadOnly)
+	int32 Released = 0;
+
+	/**Finished graphs that were destroyed because their pool was full.*/
+	UPROPERTY(Category = "Task Graph", BlueprintReadOnly)
+	int32 Discarded = 0;
+
+	UPROPERTY(Category = "Task Graph", BlueprintReadOnly)
+	int32 Prewarmed = 0;
+
+	float GetHitRate() const
+	{
+		return Hits + Misses > 0 ? static_cast<float>(Hits) / (Hits + Misses) : 0.f;
+	}
+};
+
+/**
+ * Keeps track of every task graph running in a world, indexed by
+ * owner, source and class. Graphs created through CreateGraph are
+ * registered until they finish, which replaces scanning the world's
+ * objects to find them.
+ *
+ * While registered, the subsystem keeps the graph alive.
+ *
+ * Graph classes marked as Poolable are returned to a per-class
+ * pool once they finish and reused by CreateGraph.
+ */
+UCLASS()
+class BLUEPRINTTASKSEXTENSION_API UTaskGraphSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UTaskGraphSubsystem* Get(const UObject* WorldContext);
+
+	virtual void Deinitialize() override;
+
+	/**Create and register a task graph. The graph is not started.
+	 * Poolable classes reuse a finished graph if one is available.
+	 * @Source is optional and lets you finish every graph it started
+	 * through FinishGraphsFromSource. */
+	UTaskGraph* CreateGraph(UObject* Outer, TSubclassOf<UTaskGraph> GraphClass, UObject* Source = nullptr);
+
+	void RegisterGraph(UTaskGraph* Graph, UObject* Source = nullptr);
+
+	void UnregisterGraph(UTaskGraph* Graph);
+
+	/**Is a graph of this exact class running? */
+	UFUNCTION(Category = "Task Graph", BlueprintCallable)
+	bool IsGraphRunning(TSubclassOf<UTaskGraph> GraphClass) const;
+
+	UFUNCTION(Category = "Task Graph", BlueprintCallable)
+	TArray<UTaskGraph*> GetGraphsOfClass(TSubclassOf<UTaskGraph> GraphClass) const;
+
+	UFUNCTION(Category = "Task Graph", BlueprintCallable)
+	TArray<UTaskGraph*> GetGraphsForOwner(UObject* Owner) const;
+
+	TArray<UTaskGraph*> GetGraphsFromSource(const UObject* Source) const;
+
+	/**Every registered graph.*/
+	const TMap<TObjectPtr<UTaskGraph>, FTaskGraphRegistration>& GetGraphs() const
+	{
+		return Graphs;
+	}
+
+	/**Finish every graph that was started by @Source.*/
+	void FinishGraphsFromSource(const UObject* Source);
+
+	/**Finish every graph whose outer is @Owner.*/
+	UFUNCTION(Category = "Task Graph", BlueprintCallable)
+	void FinishGraphsForOwner(UObject* Owner);
+
+	/**Capture every running graph and the SaveGame properties of
+	 * the graph and its tasks. Graphs started by a source, such as a
+	 * game feature action, are left out since their source starts them
+	 * again. Child graphs are captured as tasks of their parent. */
+	UFUNCTION(Category = "Task Graph|Save Game", BlueprintCallable)
+	FTaskGraphSnapshot CaptureSnapshot() const;
+
+	/**Recreate the graphs in @Snapshot. Graphs are not started,
+	 * RestoreGraph is called on them instead.
+	 * Graphs whose owner can't be found in this world are skipped.
+	 * Returns how many graphs were restored. */
+	UFUNCTION(Category = "Task Graph|Save Game", BlueprintCallable)
+	int32 RestoreSnapshot(const FTaskGraphSnapshot& Snapshot);
+
+	/**Create graphs of a poolable class ahead of time,
+	 * up to the class' MaxPoolSize. */
+	UFUNCTION(Category = "Task Graph|Pooling", BlueprintCallable)
+	void PrewarmPool(TSubclassOf<UTaskGraph> GraphClass, int32 Count);
+
+	/**Return a finished graph to its pool.
+	 * Returns false if the class isn't poolable or its pool is full,
+	 * in which case the caller should destroy the graph. */
+	bool ReleaseGraph(UTaskGraph* Graph);
+
+	UFUNCTION(Category = "Task Graph|Pooling", BlueprintCallable)
+	int32 GetPoolSize(TSubclassOf<UTaskGraph> GraphClass) const;
+
+	UFUNCTION(Category = "Task Graph|Pooling", BlueprintCallable)
+	FTaskGraphPoolStats GetPoolStats() const
+	{
+		return PoolStats;
+	}
+
+private:
+
+	UPROPERTY()
+	TMap<TObjectPtr<UTaskGraph>, FTaskGraphRegistration> Graphs;
+
+	/**Finished graphs waiting to be reused, outered to this subsystem.*/
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FTaskGraphPool> Pools;
+
+	/**Released graphs that go into their pool next frame, once
+	 * their event graph can't be running anymore. See ReturnPendingGraphs. */
+	UPROPERTY()
+	TArray<TObjectPtr<UTaskGraph>> PendingReleases;
+
+	/**Classes whose PoolPrewarmCount has been applied.*/
+	TSet<TObjectKey<UClass>> PrewarmedClasses;
+
+	FTaskGraphPoolStats PoolStats;
+
+	TMap<TObjectKey<UObject>, TArray<UTaskGraph*>> GraphsByOwner;
+
+	TMap<TObjectKey<UObject>, TArray<UTaskGraph*>> GraphsBySource;
+
+	TMap<TObjectKey<UClass>, TArray<UTaskGraph*>> GraphsByClass;
+
+	/**Actors that destroy themselves take their graphs with them.*/
+	UFUNCTION()
+	void OnOwningActorDestroyed(AActor* DestroyedActor);
+
+	/**Reset the event graph state of PendingReleases and move them into their pools.*/
+	void ReturnPendingGraphs();
+
+	/**Copy the list before finishing, finishing a graph unregisters it.*/
+	static void FinishGraphs(TArray<UTaskGraph*> GraphsToFinish);
+};